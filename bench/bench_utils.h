@@ -0,0 +1,70 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <poll.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../common/network_utils.h"
+#include "../common/protocol.h"
+
+class BenchUtils {
+   public:
+    static double nowUs() {
+        return std::chrono::duration<double, std::micro>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static void escape(const void* p) { asm volatile("" : : "g"(p) : "memory"); }
+
+    static double percentile(std::vector<double> samples, double p) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        std::sort(samples.begin(), samples.end());
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        return samples[index];
+    }
+
+    static double mean(const std::vector<double>& samples) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        double sum = 0.0;
+        for (double s : samples) {
+            sum += s;
+        }
+        return sum / samples.size();
+    }
+
+    static bool waitMessage(int sockfd, Message& msg, MessageType type, int timeout_ms) {
+        Endpoint from;
+        double deadline = nowUs() + timeout_ms * 1000.0;
+
+        while (nowUs() < deadline) {
+            struct pollfd pfd;
+            pfd.fd = sockfd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+
+            int remaining_ms = static_cast<int>((deadline - nowUs()) / 1000.0) + 1;
+            if (poll(&pfd, 1, remaining_ms) <= 0) {
+                continue;
+            }
+
+            while (NetworkUtils::receiveMessage(sockfd, msg, from)) {
+                if (msg.type == type) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,298 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../server/programmers_server.h"
+#include "bench_utils.h"
+
+class ServerFixture {
+   public:
+    explicit ServerFixture(int programmers)
+        : server("127.0.0.1", 0, seededOptions()),
+          transport(new MemoryTransport()),
+          client("127.0.0.1", 40000),
+          observer_id(0) {
+        server.attachTransport(std::unique_ptr<Transport>(transport));
+
+        for (int i = 0; i < programmers; i++) {
+            Message msg;
+            msg.type = REGISTER_PROGRAMMER;
+            snprintf(msg.data, sizeof(msg.data), "P%d", i);
+            deliver(msg);
+            if (i % RECEIVE_BATCH_SIZE == RECEIVE_BATCH_SIZE - 1) {
+                pump();
+            }
+        }
+        pump();
+    }
+
+    void deliver(const Message& msg) { transport->deliver(msg, client); }
+
+    void pump() {
+        server.pump();
+        transport->takeSent(sent, sent_to);
+        for (const Message& msg : sent) {
+            if (msg.type == REGISTER_PROGRAMMER) {
+                ids.push_back(msg.client_id);
+            } else if (msg.type == REGISTER_OBSERVER) {
+                observer_id = msg.client_id;
+            }
+        }
+    }
+
+    int registerObserver() {
+        Message msg;
+        msg.type = REGISTER_OBSERVER;
+        deliver(msg);
+        pump();
+        return observer_id;
+    }
+
+    std::vector<int> ids;
+
+   private:
+    static ServerOptions seededOptions() {
+        ServerOptions options;
+        options.random_seed = 1;
+        return options;
+    }
+
+    ProgrammersServer server;
+    MemoryTransport* transport;
+    Endpoint client;
+    std::vector<Message> sent;
+    std::vector<Endpoint> sent_to;
+    int observer_id;
+};
+
+class JsonReport {
+   public:
+    JsonReport() : first(true) { printf("{\n  \"suite\": \"hot_paths\",\n  \"results\": [\n"); }
+
+    ~JsonReport() { printf("\n  ]\n}\n"); }
+
+    void add(const std::string& name, int programmers, long iterations, double total_us) {
+        printf("%s    {\"name\": \"%s\", \"programmers\": %d, \"iterations\": %ld, "
+               "\"ns_per_op\": %.1f, \"ops_per_s\": %.0f}",
+               first ? "" : ",\n",
+               name.c_str(),
+               programmers,
+               iterations,
+               total_us * 1000.0 / iterations,
+               iterations / (total_us / 1e6));
+        fflush(stdout);
+        first = false;
+    }
+
+   private:
+    bool first;
+};
+
+template <typename Make>
+static double deliverAll(ServerFixture& fixture, long iterations, Make make) {
+    double start = BenchUtils::nowUs();
+    for (long i = 0; i < iterations; i++) {
+        fixture.deliver(make(i));
+        if (i % RECEIVE_BATCH_SIZE == RECEIVE_BATCH_SIZE - 1) {
+            fixture.pump();
+        }
+    }
+    fixture.pump();
+    return BenchUtils::nowUs() - start;
+}
+
+static Message submit(int author) {
+    Message msg;
+    msg.type = SUBMIT_PROGRAM;
+    msg.client_id = author;
+    msg.target_id = ANY_REVIEWER;
+    strcpy(msg.data, "bench_program");
+    return msg;
+}
+
+static void benchMessages(JsonReport& report, long iterations) {
+    double start = BenchUtils::nowUs();
+    for (long i = 0; i < iterations; i++) {
+        Message msg;
+        msg.client_id = static_cast<int>(i);
+        BenchUtils::escape(&msg);
+    }
+    report.add("message_construct", 0, iterations, BenchUtils::nowUs() - start);
+
+    Message msg = submit(42);
+    msg.program_id = 7;
+    char buf[BUFFER_SIZE];
+    size_t length = 0;
+
+    start = BenchUtils::nowUs();
+    for (long i = 0; i < iterations; i++) {
+        msg.program_id = static_cast<int>(i);
+        length = NetworkUtils::encodeMessage(msg, buf);
+        BenchUtils::escape(buf);
+    }
+    report.add("message_encode_compact", 0, iterations, BenchUtils::nowUs() - start);
+
+    Message decoded;
+    start = BenchUtils::nowUs();
+    for (long i = 0; i < iterations; i++) {
+        NetworkUtils::decodeMessage(buf, length, decoded);
+        BenchUtils::escape(&decoded);
+    }
+    report.add("message_decode_compact", 0, iterations, BenchUtils::nowUs() - start);
+}
+
+static void benchLoopback(JsonReport& report, long iterations) {
+    int sender = NetworkUtils::createUDPSocket();
+    int receiver = NetworkUtils::createUDPSocket();
+    NetworkUtils::bindSocket(sender, "127.0.0.1", 0);
+    NetworkUtils::bindSocket(receiver, "127.0.0.1", 0);
+
+    Endpoint to;
+    to.resize(Endpoint::capacity());
+    socklen_t len = to.size();
+    getsockname(receiver, to.data(), &len);
+    to.resize(len);
+
+    Message msg = submit(42);
+    Message received;
+    Endpoint from;
+    long delivered = 0;
+
+    double start = BenchUtils::nowUs();
+    for (long i = 0; i < iterations; i++) {
+        msg.program_id = static_cast<int>(i);
+        NetworkUtils::sendMessage(sender, msg, to);
+        if (NetworkUtils::receiveMessage(receiver, received, from)) {
+            delivered++;
+        }
+    }
+    report.add("loopback_send_receive", 0, delivered, BenchUtils::nowUs() - start);
+
+    close(sender);
+    close(receiver);
+}
+
+static void benchHandlers(JsonReport& report, int programmers, long iterations) {
+    {
+        ServerFixture fixture(0);
+        double us = deliverAll(fixture, iterations, [](long i) {
+            Message msg;
+            msg.type = REGISTER_PROGRAMMER;
+            snprintf(msg.data, sizeof(msg.data), "P%ld", i);
+            return msg;
+        });
+        report.add("handle_register_programmer", 0, iterations, us);
+    }
+
+    {
+        ServerFixture fixture(10);
+        long observers = iterations / 100;
+        double us = deliverAll(fixture, observers, [](long) {
+            Message msg;
+            msg.type = REGISTER_OBSERVER;
+            return msg;
+        });
+        report.add("handle_register_observer", 10, observers, us);
+    }
+
+    ServerFixture fixture(programmers);
+    const std::vector<int>& ids = fixture.ids;
+    size_t count = ids.size();
+
+    double us = deliverAll(fixture, iterations, [&ids, count](long i) {
+        Message msg;
+        msg.type = HEARTBEAT;
+        msg.client_id = ids[i % count];
+        return msg;
+    });
+    report.add("handle_heartbeat", programmers, iterations, us);
+
+    us = deliverAll(fixture, iterations, [&ids, count](long i) {
+        return submit(ids[i % count]);
+    });
+    report.add("handle_submit_program", programmers, iterations, us);
+
+    us = deliverAll(fixture, iterations, [&ids, count](long i) {
+        Message msg;
+        msg.type = REQUEST_REVIEW;
+        msg.client_id = ids[i % count];
+        return msg;
+    });
+    report.add("handle_request_review", programmers, iterations, us);
+
+    us = deliverAll(fixture, iterations, [&ids, count](long i) {
+        Message msg;
+        msg.type = REVIEW_RESULT;
+        msg.client_id = ids[i % count];
+        msg.target_id = ids[(i + 1) % count];
+        msg.program_id = static_cast<int>(i + 1);
+        msg.result = i % 3 == 0 ? INCORRECT : CORRECT;
+        return msg;
+    });
+    report.add("handle_review_result", programmers, iterations, us);
+
+    us = deliverAll(fixture, iterations, [&ids, count](long i) {
+        Message msg;
+        msg.type = REVIEW_CREDIT;
+        msg.client_id = ids[i % count];
+        msg.program_id = static_cast<int>(i / count);
+        return msg;
+    });
+    report.add("handle_review_credit", programmers, iterations, us);
+
+    us = deliverAll(fixture, count, [&ids](long i) {
+        Message msg;
+        msg.type = DISCONNECT;
+        msg.client_id = ids[i];
+        return msg;
+    });
+    report.add("handle_disconnect", programmers, count, us);
+}
+
+static void benchStatus(JsonReport& report, int programmers, long iterations) {
+    ServerFixture fixture(programmers);
+    int observer = fixture.registerObserver();
+
+    Message request;
+    request.type = STATUS_UPDATE;
+    request.client_id = observer;
+
+    double us = deliverAll(fixture, iterations, [&request](long) { return request; });
+    report.add("send_full_status_cached", programmers, iterations, us);
+
+    const std::vector<int>& ids = fixture.ids;
+    double start = BenchUtils::nowUs();
+    for (long i = 0; i < iterations; i++) {
+        Message change;
+        change.type = REVIEW_RESULT;
+        change.client_id = ids[i % ids.size()];
+        change.target_id = ids[(i + 1) % ids.size()];
+        fixture.deliver(change);
+        fixture.deliver(request);
+        fixture.pump();
+    }
+    report.add("send_full_status_render", programmers, iterations, BenchUtils::nowUs() - start);
+}
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 200000;
+    int programmers = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+    AsyncLog::instance().setLevel(LOG_OFF);
+
+    JsonReport report;
+    benchMessages(report, iterations * 10);
+    benchLoopback(report, iterations / 4);
+    benchHandlers(report, programmers, iterations);
+
+    const int status_sizes[] = {10, 1000, 100000};
+    for (int size : status_sizes) {
+        benchStatus(report, size, std::max(5L, 100000L / size));
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "../server/async_log.h"
+#include "bench_utils.h"
+
+class SlowPipe {
+   public:
+    explicit SlowPipe(int bytes_per_ms) : bytes_per_ms(bytes_per_ms), lines(0) {
+        if (pipe(fds) != 0) {
+            perror("pipe");
+            exit(1);
+        }
+        saved_stdout = dup(STDOUT_FILENO);
+        fflush(stdout);
+        dup2(fds[1], STDOUT_FILENO);
+        reader = std::thread(&SlowPipe::drain, this);
+    }
+
+    size_t finish() {
+        std::cout.flush();
+        fflush(stdout);
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+        close(fds[1]);
+        reader.join();
+        close(fds[0]);
+        return lines;
+    }
+
+   private:
+    void drain() {
+        char buffer[4096];
+        while (true) {
+            ssize_t len = read(fds[0], buffer, std::min(sizeof(buffer), size_t(bytes_per_ms)));
+            if (len <= 0) {
+                return;
+            }
+            for (ssize_t i = 0; i < len; i++) {
+                lines += buffer[i] == '\n';
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    int fds[2];
+    int saved_stdout;
+    int bytes_per_ms;
+    size_t lines;
+    std::thread reader;
+};
+
+static Message sampleMessage(int i) {
+    Message msg;
+    msg.type = i % 2 ? HEARTBEAT : SUBMIT_PROGRAM;
+    msg.client_id = 1 + i % 100;
+    msg.target_id = 2 + i % 100;
+    msg.program_id = i;
+    snprintf(msg.data, sizeof(msg.data), "Программа_%d", i);
+    return msg;
+}
+
+static void report(const char* name, int count, double elapsed_us, size_t lines) {
+    printf("%-12s messages=%d handler=%.0fns/msg total=%.1fms lines=%zu\n", name, count,
+           elapsed_us * 1000.0 / count, elapsed_us / 1000.0, lines);
+}
+
+static void runSync(int count, int bytes_per_ms) {
+    SlowPipe pipe_out(bytes_per_ms);
+
+    double start = BenchUtils::nowUs();
+    for (int i = 0; i < count; i++) {
+        NetworkUtils::printMessage("Получено: ", sampleMessage(i));
+    }
+    double elapsed = BenchUtils::nowUs() - start;
+
+    report("cout", count, elapsed, pipe_out.finish());
+}
+
+static void runAsync(const char* name, int count, int bytes_per_ms, uint32_t sample_every) {
+    AsyncLog& log = AsyncLog::instance();
+    log.setSampleEvery(sample_every);
+
+    SlowPipe pipe_out(bytes_per_ms);
+    log.start();
+
+    double start = BenchUtils::nowUs();
+    for (int i = 0; i < count; i++) {
+        log.message(LOG_DEBUG, sampleMessage(i));
+    }
+    double elapsed = BenchUtils::nowUs() - start;
+
+    log.stop();
+    report(name, count, elapsed, pipe_out.finish());
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int bytes_per_ms = argc > 2 ? std::atoi(argv[2]) : 1024;
+
+    printf("stdout drained at %d KB/s\n", bytes_per_ms * 1000 / 1024);
+    runSync(count, bytes_per_ms);
+    runAsync("async", count, bytes_per_ms, 1);
+    runAsync("async/16", count, bytes_per_ms, 16);
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../server/programmers_server.h"
+#include "bench_utils.h"
+
+static pid_t startServer(const std::string& ip, int port, LoopMode mode) {
+    std::cout.flush();
+    fflush(stdout);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (!freopen("/dev/null", "w", stdout)) {
+            _exit(1);
+        }
+        ServerOptions options;
+        options.loop_mode = mode;
+        ProgrammersServer server(ip, port, options);
+        _exit(server.start() ? 0 : 1);
+    }
+    return pid;
+}
+
+static void stopServer(pid_t pid) {
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+}
+
+static bool measure(const std::string& ip, int port, int rounds, std::vector<double>& samples) {
+    int sockfd = NetworkUtils::createUDPSocket();
+    if (sockfd < 0 || !NetworkUtils::bindSocket(sockfd, ip, 0)) {
+        return false;
+    }
+
+    Endpoint server(ip, port);
+    Message msg;
+    msg.type = REGISTER_PROGRAMMER;
+    strcpy(msg.data, "bench");
+    NetworkUtils::sendMessage(sockfd, msg, server);
+
+    if (!BenchUtils::waitMessage(sockfd, msg, REGISTER_PROGRAMMER, 2000)) {
+        close(sockfd);
+        return false;
+    }
+    int client_id = msg.client_id;
+
+    for (int i = 0; i < rounds; i++) {
+        Message request;
+        request.type = REQUEST_REVIEW;
+        request.client_id = client_id;
+
+        double start = BenchUtils::nowUs();
+        NetworkUtils::sendMessage(sockfd, request, server);
+        if (!BenchUtils::waitMessage(sockfd, msg, REQUEST_REVIEW, 1000)) {
+            continue;
+        }
+        samples.push_back(BenchUtils::nowUs() - start);
+    }
+
+    close(sockfd);
+    return true;
+}
+
+static void report(const char* name, const std::vector<double>& samples, int rounds) {
+    printf("%-6s rounds=%d ok=%zu mean=%.1fus p50=%.1fus p99=%.1fus max=%.1fus\n",
+           name,
+           rounds,
+           samples.size(),
+           BenchUtils::mean(samples),
+           BenchUtils::percentile(samples, 0.50),
+           BenchUtils::percentile(samples, 0.99),
+           BenchUtils::percentile(samples, 1.0));
+}
+
+int main(int argc, char* argv[]) {
+    std::string ip = argc > 1 ? argv[1] : "127.0.0.1";
+    int port = argc > 2 ? std::atoi(argv[2]) : 9100;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 50;
+
+    struct {
+        const char* name;
+        LoopMode mode;
+    } modes[] = {{"poll", LOOP_POLL}, {"epoll", LOOP_EPOLL}};
+
+    for (const auto& m : modes) {
+        pid_t pid = startServer(ip, port, m.mode);
+        usleep(200000);
+
+        std::vector<double> samples;
+        if (!measure(ip, port, rounds, samples)) {
+            std::cout << m.name << ": сервер не ответил на регистрацию" << std::endl;
+        } else {
+            report(m.name, samples, rounds);
+        }
+
+        stopServer(pid);
+        port++;
+    }
+
+    return 0;
+}
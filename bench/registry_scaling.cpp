@@ -0,0 +1,132 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../server/programmer_registry.h"
+#include "bench_utils.h"
+
+struct MapTable {
+    std::map<int, ProgrammerInfo> programmers;
+    std::map<int, std::pair<std::string, int>> addresses;
+    std::map<int, std::queue<ProgramReview>> review_queues;
+
+    void add(int id, const std::string& name, int port) {
+        ProgrammerInfo info;
+        info.id = id;
+        info.name = name;
+        info.state = WRITING;
+        info.programs_written = 0;
+        info.programs_reviewed = 0;
+        info.current_program_id = 0;
+        info.current_activity = "Starting work";
+        info.last_activity = time(nullptr);
+        info.is_connected = true;
+        programmers[id] = info;
+        addresses[id] = std::make_pair(std::string("127.0.0.1"), port);
+        review_queues[id];
+    }
+
+    long update(int id, time_t now) {
+        auto it = programmers.find(id);
+        if (it == programmers.end()) {
+            return 0;
+        }
+        it->second.programs_reviewed++;
+        it->second.state = REVIEWING;
+        it->second.last_activity = now;
+        return addresses[id].second + static_cast<long>(review_queues[id].size());
+    }
+
+    long scan() const {
+        long sum = 0;
+        for (const auto& pair : programmers) {
+            if (pair.second.is_connected && pair.second.state != SLEEPING) {
+                sum += pair.second.programs_reviewed;
+            }
+        }
+        return sum;
+    }
+};
+
+struct RegistryTable {
+    ProgrammerRegistry registry;
+
+    void add(int, const std::string& name, int port) {
+        registry.add(name, Endpoint("127.0.0.1", port), name);
+    }
+
+    long update(int id, time_t now) {
+        size_t slot;
+        if (!registry.find(id, slot)) {
+            return 0;
+        }
+        registry.programs_reviewed[slot]++;
+        registry.state[slot] = REVIEWING;
+        registry.last_activity[slot] = now;
+        return registry.address[slot].port() +
+               static_cast<long>(registry.review_queue[slot].size());
+    }
+
+    long scan() const {
+        long sum = 0;
+        for (size_t slot = 0; slot < registry.size(); slot++) {
+            if (registry.connected[slot] && registry.state[slot] != SLEEPING) {
+                sum += registry.programs_reviewed[slot];
+            }
+        }
+        return sum;
+    }
+};
+
+template <typename Table>
+static void run(const char* name, int count, const std::vector<int>& ids, int scans) {
+    Table table;
+
+    double start = BenchUtils::nowUs();
+    for (int id = 1; id <= count; id++) {
+        table.add(id, "Программист" + std::to_string(id), 10000 + id % 50000);
+    }
+    double fill_us = BenchUtils::nowUs() - start;
+
+    time_t now = time(nullptr);
+    long checksum = 0;
+    start = BenchUtils::nowUs();
+    for (int id : ids) {
+        checksum += table.update(id, now);
+    }
+    double lookup_us = BenchUtils::nowUs() - start;
+
+    start = BenchUtils::nowUs();
+    for (int i = 0; i < scans; i++) {
+        checksum += table.scan();
+    }
+    double scan_us = BenchUtils::nowUs() - start;
+
+    printf("%-9s programmers=%d fill=%.1fms lookup=%.1fns/op scan=%.2fns/programmer "
+           "checksum=%ld\n",
+           name, count, fill_us / 1000.0, lookup_us * 1000.0 / ids.size(),
+           scan_us * 1000.0 / (static_cast<double>(scans) * count), checksum);
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int lookups = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    int scans = 50;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pick(1, count);
+    std::vector<int> ids(lookups);
+    for (int& id : ids) {
+        id = pick(rng);
+    }
+
+    run<MapTable>("map", count, ids, scans);
+    run<RegistryTable>("registry", count, ids, scans);
+    return 0;
+}
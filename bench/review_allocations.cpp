@@ -0,0 +1,239 @@
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../server/programmers_server.h"
+#include "bench_utils.h"
+
+static size_t allocations = 0;
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocations++;
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept { free(ptr); }
+
+__attribute__((noinline)) void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+
+struct QueueTable {
+    std::vector<std::queue<ProgramReview>> queues;
+    std::vector<std::string> activity;
+
+    explicit QueueTable(int count) : queues(count), activity(count) {}
+
+    void submit(int author, int target, int program_id, const char* program_name) {
+        queues[target].push(ProgramReview(program_id, author, target, program_name));
+        activity[author] = std::string("Ожидает проверки программы ") + program_name;
+    }
+
+    long review(int reviewer) {
+        if (queues[reviewer].empty()) {
+            return 0;
+        }
+        ProgramReview review = queues[reviewer].front();
+        queues[reviewer].pop();
+        activity[reviewer] = "Проверяет программу '" + review.program_name + "'";
+        activity[reviewer] = "Пишет новую программу";
+        return review.program_id + static_cast<long>(review.program_name.size());
+    }
+};
+
+struct PoolTable {
+    ProgrammerRegistry registry;
+
+    explicit PoolTable(int count) {
+        for (int i = 0; i < count; i++) {
+            registry.add("Программист", Endpoint("127.0.0.1", 10000 + i), "Программист");
+        }
+    }
+
+    void submit(int author, int target, int program_id, const char* program_name) {
+        registry.pushReview(target, program_id, author, program_name);
+        registry.setActivity(author, ACTIVITY_WAITING_REVIEW, program_id, program_name);
+    }
+
+    long review(int reviewer) {
+        if (registry.review_queue[reviewer].empty()) {
+            return 0;
+        }
+        const ReviewRecord& review = registry.frontReview(reviewer);
+        long value = review.program_id +
+                     static_cast<long>(strlen(registry.strings.get(review.program_name)));
+        registry.setActivity(reviewer, ACTIVITY_REVIEWING, review.program_id, review.program_name);
+        registry.popReview(reviewer);
+        registry.setActivity(reviewer, ACTIVITY_WRITING);
+        return value;
+    }
+};
+
+static const char* programName(int program_id, int author) {
+    static char name[sizeof(Message::data)];
+    snprintf(name, sizeof(name), "Программа_%d_от_Программист%d", program_id, author);
+    return name;
+}
+
+template <typename Table>
+static size_t run(const char* name, int count, int rounds) {
+    Table table(count);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> pick(0, count - 1);
+    int program_id = 1;
+    long checksum = 0;
+
+    for (int target = 0; target < count; target++) {
+        for (int i = 0; i < 2; i++) {
+            int author = pick(rng);
+            table.submit(author, target, program_id, programName(program_id, author));
+            program_id++;
+        }
+    }
+
+    size_t before = 0;
+    double start = 0;
+    for (int i = 0; i < 2 * rounds; i++) {
+        if (i == rounds) {
+            before = allocations;
+            start = BenchUtils::nowUs();
+        }
+        int target = pick(rng);
+        int author = pick(rng);
+        table.submit(author, target, program_id, programName(program_id, author));
+        program_id++;
+        checksum += table.review(target);
+    }
+    double elapsed_us = BenchUtils::nowUs() - start;
+    size_t steady = allocations - before;
+
+    printf("%-6s programmers=%d cycles=%d allocations=%zu (%.2f/cycle) cost=%.1fns/cycle "
+           "checksum=%ld\n",
+           name, count, rounds, steady, static_cast<double>(steady) / rounds,
+           elapsed_us * 1000.0 / rounds, checksum);
+    return steady;
+}
+
+class ServerCycle {
+   public:
+    explicit ServerCycle(int count)
+        : server("127.0.0.1", 0, seededOptions()),
+          transport(new MemoryTransport()),
+          client("127.0.0.1", 40000),
+          program_id(0) {
+        server.attachTransport(std::unique_ptr<Transport>(transport));
+
+        for (int i = 0; i < count; i++) {
+            Message msg;
+            msg.type = REGISTER_PROGRAMMER;
+            snprintf(msg.data, sizeof(msg.data), "Программист_%d", i + 1);
+            transport->deliver(msg, client);
+            pump();
+        }
+    }
+
+    long cycle(int author, int reviewer) {
+        Message msg;
+        msg.type = SUBMIT_PROGRAM;
+        msg.client_id = ids[author];
+        msg.target_id = ids[reviewer];
+        snprintf(msg.data, sizeof(msg.data), "Программа_от_%d", author + 1);
+        transport->deliver(msg, client);
+        pump();
+
+        msg = Message();
+        msg.type = REQUEST_REVIEW;
+        msg.client_id = ids[reviewer];
+        transport->deliver(msg, client);
+        pump();
+
+        msg = Message();
+        msg.type = REVIEW_RESULT;
+        msg.client_id = ids[reviewer];
+        msg.target_id = ids[author];
+        msg.program_id = program_id;
+        msg.result = program_id % 3 == 0 ? INCORRECT : CORRECT;
+        transport->deliver(msg, client);
+        pump();
+        return program_id;
+    }
+
+    size_t size() const { return ids.size(); }
+
+   private:
+    static ServerOptions seededOptions() {
+        ServerOptions options;
+        options.random_seed = 1;
+        return options;
+    }
+
+    void pump() {
+        server.pump();
+        transport->takeSent(sent, sent_to);
+        for (const Message& reply : sent) {
+            if (reply.type == REGISTER_PROGRAMMER) {
+                ids.push_back(reply.client_id);
+            } else if (reply.type == REQUEST_REVIEW && reply.program_id != 0) {
+                program_id = reply.program_id;
+            }
+        }
+    }
+
+    ProgrammersServer server;
+    MemoryTransport* transport;
+    Endpoint client;
+    std::vector<int> ids;
+    std::vector<Message> sent;
+    std::vector<Endpoint> sent_to;
+    int program_id;
+};
+
+static size_t runServer(int count, int rounds) {
+    ServerCycle server(count);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> pick(0, count - 1);
+    long checksum = 0;
+
+    size_t before = 0;
+    double start = 0;
+    for (int i = 0; i < 2 * rounds; i++) {
+        if (i == rounds) {
+            before = allocations;
+            start = BenchUtils::nowUs();
+        }
+        int author = pick(rng);
+        int reviewer = (author + 1 + pick(rng) % (count - 1)) % count;
+        checksum += server.cycle(author, reviewer);
+    }
+    double elapsed_us = BenchUtils::nowUs() - start;
+    size_t steady = allocations - before;
+
+    printf("%-6s programmers=%zu cycles=%d allocations=%zu (%.2f/cycle) cost=%.1fns/cycle "
+           "checksum=%ld\n",
+           "server", server.size(), rounds, steady, static_cast<double>(steady) / rounds,
+           elapsed_us * 1000.0 / rounds, checksum);
+    return steady;
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 200000;
+
+    AsyncLog::instance().setLevel(LOG_OFF);
+
+    run<QueueTable>("queue", count, rounds);
+    size_t pooled = run<PoolTable>("pool", count, rounds);
+    size_t handled = runServer(std::max(2, count / 10), rounds / 10);
+
+    if (pooled != 0 || handled != 0) {
+        printf("ОШИБКА: очередь проверок выделяет память в установившемся режиме\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "../server/reviewer_picker.h"
+#include "bench_utils.h"
+
+struct Reviewer {
+    double mean_service;
+    double busy_until;
+    std::deque<double> finishes;
+
+    size_t depth(double now) {
+        while (!finishes.empty() && finishes.front() <= now) {
+            finishes.pop_front();
+        }
+        return finishes.size();
+    }
+};
+
+struct Workload {
+    std::vector<double> arrivals;
+    std::vector<double> work;
+    std::vector<double> speeds;
+};
+
+static Workload makeWorkload(int reviewers, int jobs, double load) {
+    Workload workload;
+    double capacity = 0.0;
+    for (int i = 0; i < reviewers; i++) {
+        double mean = i % 5 == 0 ? 4.0 : 1.0;
+        workload.speeds.push_back(mean);
+        capacity += 1.0 / mean;
+    }
+
+    std::mt19937 rng(7);
+    std::exponential_distribution<double> gap(capacity * load);
+    std::exponential_distribution<double> work(1.0);
+
+    double now = 0.0;
+    for (int i = 0; i < jobs; i++) {
+        now += gap(rng);
+        workload.arrivals.push_back(now);
+        workload.work.push_back(work(rng));
+    }
+    return workload;
+}
+
+template <typename Pick>
+static void run(const char* name, const Workload& workload, Pick pick) {
+    std::vector<Reviewer> reviewers(workload.speeds.size());
+    for (size_t i = 0; i < reviewers.size(); i++) {
+        reviewers[i].mean_service = workload.speeds[i];
+        reviewers[i].busy_until = 0.0;
+    }
+
+    std::vector<double> waits;
+    waits.reserve(workload.arrivals.size());
+    size_t max_depth = 0;
+
+    for (size_t job = 0; job < workload.arrivals.size(); job++) {
+        double now = workload.arrivals[job];
+        size_t slot = pick(reviewers, now);
+
+        Reviewer& reviewer = reviewers[slot];
+        max_depth = std::max(max_depth, reviewer.depth(now) + 1);
+
+        double start = std::max(now, reviewer.busy_until);
+        reviewer.busy_until = start + workload.work[job] * reviewer.mean_service;
+        reviewer.finishes.push_back(reviewer.busy_until);
+        waits.push_back(reviewer.busy_until - now);
+    }
+
+    double makespan = 0.0;
+    for (const Reviewer& reviewer : reviewers) {
+        makespan = std::max(makespan, reviewer.busy_until);
+    }
+
+    printf("%-12s time_to_review mean=%.2f p50=%.2f p99=%.2f max_queue=%zu "
+           "throughput=%.3f/unit\n",
+           name, BenchUtils::mean(waits), BenchUtils::percentile(waits, 0.50),
+           BenchUtils::percentile(waits, 0.99), max_depth, waits.size() / makespan);
+}
+
+static void runPolicy(const char* name, const Workload& workload, AssignPolicy policy) {
+    ReviewerPicker picker(policy, 11);
+    for (size_t i = 0; i < workload.speeds.size(); i++) {
+        picker.add(i);
+    }
+
+    run(name, workload, [&picker](std::vector<Reviewer>& reviewers, double now) {
+        for (size_t slot = 0; slot < reviewers.size(); slot++) {
+            picker.update(slot, reviewers[slot].depth(now));
+        }
+        return picker.pick(ReviewerPicker::NONE,
+                           [&reviewers, now](size_t slot) { return reviewers[slot].depth(now); });
+    });
+}
+
+int main(int argc, char* argv[]) {
+    int reviewers = argc > 1 ? std::atoi(argv[1]) : 10;
+    int jobs = argc > 2 ? std::atoi(argv[2]) : 200000;
+    double load = argc > 3 ? std::atof(argv[3]) : 0.8;
+
+    Workload workload = makeWorkload(reviewers, jobs, load);
+    printf("reviewers=%d (every 5th is 4x slower) jobs=%d load=%.2f\n", reviewers, jobs, load);
+
+    std::mt19937 rng(11);
+    run("random", workload, [&rng](std::vector<Reviewer>& all, double) {
+        return std::uniform_int_distribution<size_t>(0, all.size() - 1)(rng);
+    });
+    runPolicy("round-robin", workload, ASSIGN_ROUND_ROBIN);
+    runPolicy("two-choices", workload, ASSIGN_TWO_CHOICES);
+    runPolicy("least-queue", workload, ASSIGN_LEAST_QUEUE);
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../server/programmers_server.h"
+#include "bench_utils.h"
+
+const int REGISTER_WINDOW = 64;
+
+static pid_t startServer(const std::string& ip, int port) {
+    std::cout.flush();
+    fflush(stdout);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (!freopen("/dev/null", "w", stdout)) {
+            _exit(1);
+        }
+        AsyncLog::instance().setLevel(LOG_WARN);
+        ProgrammersServer server(ip, port, ServerOptions());
+        _exit(server.start() ? 0 : 1);
+    }
+    return pid;
+}
+
+static void stopServer(pid_t pid) {
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+}
+
+static int openSocket(const std::string& ip) {
+    int sockfd = NetworkUtils::createUDPSocket();
+    if (sockfd >= 0 && !NetworkUtils::bindSocket(sockfd, ip, 0)) {
+        close(sockfd);
+        return -1;
+    }
+    return sockfd;
+}
+
+static bool registerObserver(int sockfd, const Endpoint& server) {
+    Message msg;
+    msg.type = REGISTER_OBSERVER;
+    msg.target_id = STATUS_STREAM_VERSION;
+    NetworkUtils::sendMessage(sockfd, msg, server);
+    return BenchUtils::waitMessage(sockfd, msg, REGISTER_OBSERVER, 2000);
+}
+
+static bool registerProgrammers(int sockfd, const Endpoint& server, int count) {
+    int sent = 0;
+    int received = 0;
+    Message msg;
+
+    while (received < count) {
+        while (sent < count && sent - received < REGISTER_WINDOW) {
+            Message request;
+            request.type = REGISTER_PROGRAMMER;
+            snprintf(request.data, sizeof(request.data), "P%d", sent);
+            NetworkUtils::sendMessage(sockfd, request, server);
+            sent++;
+        }
+
+        if (!BenchUtils::waitMessage(sockfd, msg, REGISTER_PROGRAMMER, 2000)) {
+            return false;
+        }
+        received++;
+    }
+    return true;
+}
+
+static void measure(int sockfd, const Endpoint& server, int count, int rounds) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> any_id(1, count);
+    std::vector<double> samples;
+    Message msg;
+
+    double start = BenchUtils::nowUs();
+    for (int i = 0; i < rounds; i++) {
+        double round_start = BenchUtils::nowUs();
+
+        Message heartbeat;
+        heartbeat.type = HEARTBEAT;
+        heartbeat.client_id = any_id(rng);
+        NetworkUtils::sendMessage(sockfd, heartbeat, server);
+
+        Message submit;
+        submit.type = SUBMIT_PROGRAM;
+        submit.client_id = any_id(rng);
+        submit.target_id = ANY_REVIEWER;
+        snprintf(submit.data, sizeof(submit.data), "bench_%d", i);
+        NetworkUtils::sendMessage(sockfd, submit, server);
+
+        Message request;
+        request.type = REQUEST_REVIEW;
+        request.client_id = any_id(rng);
+        NetworkUtils::sendMessage(sockfd, request, server);
+
+        if (BenchUtils::waitMessage(sockfd, msg, REQUEST_REVIEW, 1000)) {
+            samples.push_back(BenchUtils::nowUs() - round_start);
+        }
+    }
+    double elapsed = BenchUtils::nowUs() - start;
+
+    printf("programmers=%-7d rounds=%d ok=%zu per_msg=%.1fus round p50=%.1fus p99=%.1fus\n",
+           count,
+           rounds,
+           samples.size(),
+           elapsed / (3.0 * rounds),
+           BenchUtils::percentile(samples, 0.50),
+           BenchUtils::percentile(samples, 0.99));
+}
+
+int main(int argc, char* argv[]) {
+    std::string ip = argc > 1 ? argv[1] : "127.0.0.1";
+    int port = argc > 2 ? std::atoi(argv[2]) : 9150;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 2000;
+    int max_count = argc > 4 ? std::atoi(argv[4]) : 100000;
+
+    for (int count = 1000; count <= max_count; count *= 10) {
+        pid_t pid = startServer(ip, port);
+        usleep(200000);
+
+        Endpoint server(ip, port);
+        int observer = openSocket(ip);
+        int clients = openSocket(ip);
+        int probe = openSocket(ip);
+
+        double start = BenchUtils::nowUs();
+        if (observer < 0 || clients < 0 || probe < 0 || !registerObserver(observer, server) ||
+            !registerProgrammers(clients, server, count)) {
+            std::cout << "programmers=" << count << ": сервер не ответил на регистрацию"
+                      << std::endl;
+        } else {
+            double register_us = (BenchUtils::nowUs() - start) / count;
+            printf("programmers=%-7d register=%.1fus/programmer\n", count, register_us);
+            measure(probe, server, count, rounds);
+        }
+
+        close(observer);
+        close(clients);
+        close(probe);
+        stopServer(pid);
+        port++;
+    }
+
+    return 0;
+}
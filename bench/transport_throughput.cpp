@@ -0,0 +1,163 @@
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../common/network_utils.h"
+#include "../common/transport.h"
+#include "../common/uring_transport.h"
+#include "bench_utils.h"
+
+enum BenchMode { MODE_RECVFROM, MODE_RECVMMSG, MODE_URING };
+
+static const int BURST = 64;
+static const int ROUND = 4096;
+static const int RECEIVE_BUFFER = 4 << 20;
+
+struct RunResult {
+    int delivered;
+    double cpu_us;
+};
+
+static int localPort(int sockfd) {
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    getsockname(sockfd, (struct sockaddr*)&addr, &len);
+    return ntohs(addr.sin_port);
+}
+
+static double threadCpuUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void sender(int sockfd, int port, int count) {
+    std::vector<Message> burst(BURST);
+    std::vector<Endpoint> to(BURST, Endpoint("127.0.0.1", port));
+
+    for (auto& msg : burst) {
+        msg.type = HEARTBEAT;
+        msg.client_id = 1;
+    }
+
+    for (int sent = 0; sent < count; sent += BURST) {
+        NetworkUtils::sendMessages(sockfd, burst, to);
+    }
+}
+
+static int drain(BenchMode mode,
+                 int sockfd,
+                 Transport& transport,
+                 std::vector<Message>& batch,
+                 std::vector<Endpoint>& from,
+                 const Endpoint* reply_to) {
+    struct pollfd pfd;
+    pfd.fd = transport.pollFd();
+    pfd.events = POLLIN;
+
+    int received = 0;
+    while (poll(&pfd, 1, 0) > 0) {
+        if (mode == MODE_RECVFROM) {
+            Endpoint source;
+            while (NetworkUtils::receiveMessage(sockfd, batch[0], source)) {
+                if (reply_to) {
+                    NetworkUtils::sendMessage(sockfd, batch[0], *reply_to);
+                }
+                received++;
+            }
+        } else {
+            int n;
+            do {
+                n = transport.receiveMessages(batch, from);
+                for (int i = 0; reply_to && i < n; i++) {
+                    transport.sendMessage(batch[i], *reply_to);
+                }
+                received += n;
+            } while (n == static_cast<int>(batch.size()));
+            transport.flush();
+        }
+    }
+    return received;
+}
+
+static bool run(BenchMode mode, bool reply, int total, RunResult& result) {
+    int sockfd = NetworkUtils::createUDPSocket();
+    int sink = NetworkUtils::createUDPSocket();
+    NetworkUtils::bindSocket(sockfd, "127.0.0.1", 0);
+    NetworkUtils::bindSocket(sink, "127.0.0.1", 0);
+    setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &RECEIVE_BUFFER, sizeof(RECEIVE_BUFFER));
+    int port = localPort(sockfd);
+    int sink_port = localPort(sink);
+
+    std::unique_ptr<Transport> transport;
+    if (mode == MODE_URING) {
+        std::unique_ptr<UringTransport> uring(new UringTransport(sockfd));
+        if (!uring->init()) {
+            close(sockfd);
+            close(sink);
+            return false;
+        }
+        transport.reset(uring.release());
+    } else {
+        transport.reset(new SocketTransport(sockfd));
+    }
+
+    int source = NetworkUtils::createUDPSocket();
+    std::vector<Message> batch(32);
+    std::vector<Endpoint> from(32);
+    Endpoint sink_endpoint("127.0.0.1", sink_port);
+
+    int received = 0;
+    double cpu_start = threadCpuUs();
+    for (int sent = 0; sent < total; sent += ROUND) {
+        std::thread producer(sender, source, port, std::min(ROUND, total - sent));
+        producer.join();
+        received += drain(mode, sockfd, *transport, batch, from, reply ? &sink_endpoint : nullptr);
+    }
+
+    result.cpu_us = threadCpuUs() - cpu_start;
+    result.delivered = received;
+
+    close(source);
+    transport.reset();
+    close(sockfd);
+    close(sink);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int total = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+    struct {
+        const char* name;
+        BenchMode mode;
+    } modes[] = {
+        {"recvfrom", MODE_RECVFROM}, {"recvmmsg", MODE_RECVMMSG}, {"io_uring", MODE_URING}};
+
+    for (const auto& m : modes) {
+        RunResult receive;
+        RunResult echo;
+        if (!run(m.mode, false, total, receive) || !run(m.mode, true, total, echo)) {
+            printf("%-9s недоступен\n", m.name);
+            continue;
+        }
+        printf("%-9s received=%d/%d receive=%.2fus/msg receive+reply=%.2fus/msg\n",
+               m.name,
+               receive.delivered,
+               total,
+               receive.cpu_us / std::max(receive.delivered, 1),
+               echo.cpu_us / std::max(echo.delivered, 1));
+    }
+
+    return 0;
+}
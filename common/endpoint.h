@@ -0,0 +1,121 @@
+#ifndef ENDPOINT_H
+#define ENDPOINT_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+class Endpoint {
+   public:
+    Endpoint() : length(0) { memset(&storage, 0, sizeof(storage)); }
+
+    Endpoint(const std::string& ip, int port) : length(0) { assign(ip, port); }
+
+    bool assign(const std::string& ip, int port) {
+        memset(&storage, 0, sizeof(storage));
+        length = 0;
+
+        if (port < 0 || port > 65535) {
+            return false;
+        }
+
+        struct sockaddr_in* v4 = reinterpret_cast<struct sockaddr_in*>(&storage);
+        if (inet_pton(AF_INET, ip.c_str(), &v4->sin_addr) == 1) {
+            v4->sin_family = AF_INET;
+            v4->sin_port = htons(static_cast<uint16_t>(port));
+            length = sizeof(*v4);
+            return true;
+        }
+
+        struct sockaddr_in6* v6 = reinterpret_cast<struct sockaddr_in6*>(&storage);
+        if (inet_pton(AF_INET6, ip.c_str(), &v6->sin6_addr) == 1) {
+            v6->sin6_family = AF_INET6;
+            v6->sin6_port = htons(static_cast<uint16_t>(port));
+            length = sizeof(*v6);
+            return true;
+        }
+
+        memset(&storage, 0, sizeof(storage));
+        return false;
+    }
+
+    struct sockaddr* data() { return reinterpret_cast<struct sockaddr*>(&storage); }
+
+    const struct sockaddr* data() const {
+        return reinterpret_cast<const struct sockaddr*>(&storage);
+    }
+
+    socklen_t size() const { return length; }
+
+    static socklen_t capacity() { return sizeof(struct sockaddr_storage); }
+
+    void resize(socklen_t len) { length = len; }
+
+    bool valid() const { return length != 0; }
+
+    int port() const {
+        if (storage.ss_family == AF_INET6) {
+            return ntohs(v6().sin6_port);
+        }
+        return storage.ss_family == AF_INET ? ntohs(v4().sin_port) : 0;
+    }
+
+    std::string ip() const {
+        char text[INET6_ADDRSTRLEN] = "";
+        if (storage.ss_family == AF_INET) {
+            inet_ntop(AF_INET, &v4().sin_addr, text, sizeof(text));
+        } else if (storage.ss_family == AF_INET6) {
+            inet_ntop(AF_INET6, &v6().sin6_addr, text, sizeof(text));
+        }
+        return text;
+    }
+
+    std::string toString() const { return ip() + ":" + std::to_string(port()); }
+
+    bool operator==(const Endpoint& other) const { return compare(other) == 0; }
+    bool operator!=(const Endpoint& other) const { return compare(other) != 0; }
+    bool operator<(const Endpoint& other) const { return compare(other) < 0; }
+
+   private:
+    const struct sockaddr_in& v4() const {
+        return *reinterpret_cast<const struct sockaddr_in*>(&storage);
+    }
+
+    const struct sockaddr_in6& v6() const {
+        return *reinterpret_cast<const struct sockaddr_in6*>(&storage);
+    }
+
+    int compare(const Endpoint& other) const {
+        if (storage.ss_family != other.storage.ss_family) {
+            return storage.ss_family < other.storage.ss_family ? -1 : 1;
+        }
+
+        if (storage.ss_family == AF_INET) {
+            if (v4().sin_port != other.v4().sin_port) {
+                return v4().sin_port < other.v4().sin_port ? -1 : 1;
+            }
+            return memcmp(&v4().sin_addr, &other.v4().sin_addr, sizeof(struct in_addr));
+        }
+
+        if (storage.ss_family == AF_INET6) {
+            if (v6().sin6_port != other.v6().sin6_port) {
+                return v6().sin6_port < other.v6().sin6_port ? -1 : 1;
+            }
+            if (v6().sin6_scope_id != other.v6().sin6_scope_id) {
+                return v6().sin6_scope_id < other.v6().sin6_scope_id ? -1 : 1;
+            }
+            return memcmp(&v6().sin6_addr, &other.v6().sin6_addr, sizeof(struct in6_addr));
+        }
+
+        return 0;
+    }
+
+    struct sockaddr_storage storage;
+    socklen_t length;
+};
+
+#endif
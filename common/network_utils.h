@@ -7,12 +7,25 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "endpoint.h"
 #include "protocol.h"
 
+class DatagramTap {
+   public:
+    virtual ~DatagramTap() {}
+
+    virtual void capture(const char* data, size_t length, bool truncated, const Endpoint& from) = 0;
+};
+
 class NetworkUtils {
    public:
     static int createUDPSocket() {
@@ -28,6 +41,76 @@ class NetworkUtils {
         return sockfd;
     }
 
+    static bool enableReusePort(int sockfd) {
+        int enable = 1;
+        if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+            perror("SO_REUSEPORT failed");
+            return false;
+        }
+        return true;
+    }
+
+    static bool enableReuseAddr(int sockfd) {
+        int enable = 1;
+        if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0) {
+            perror("SO_REUSEADDR failed");
+            return false;
+        }
+        return true;
+    }
+
+    static bool setMulticastInterface(int sockfd, const std::string& interface_ip) {
+        struct in_addr addr;
+        if (inet_pton(AF_INET, interface_ip.c_str(), &addr) != 1) {
+            return false;
+        }
+
+        if (setsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_IF, &addr, sizeof(addr)) < 0) {
+            perror("IP_MULTICAST_IF failed");
+            return false;
+        }
+
+        unsigned char loop = 1;
+        setsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+        return true;
+    }
+
+    static bool joinMulticastGroup(int sockfd,
+                                   const std::string& group,
+                                   const std::string& interface_ip) {
+        struct ip_mreq mreq;
+        memset(&mreq, 0, sizeof(mreq));
+
+        if (inet_pton(AF_INET, group.c_str(), &mreq.imr_multiaddr) != 1) {
+            return false;
+        }
+
+        if (interface_ip.empty()) {
+            mreq.imr_interface.s_addr = INADDR_ANY;
+        } else if (inet_pton(AF_INET, interface_ip.c_str(), &mreq.imr_interface) != 1) {
+            return false;
+        }
+
+        if (setsockopt(sockfd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+            perror("IP_ADD_MEMBERSHIP failed");
+            return false;
+        }
+        return true;
+    }
+
+    static bool parseEndpoint(const std::string& value, std::string& ip, int& port) {
+        size_t colon = value.rfind(':');
+        if (colon == std::string::npos) {
+            return false;
+        }
+
+        ip = value.substr(0, colon);
+        port = std::atoi(value.c_str() + colon + 1);
+
+        struct in_addr addr;
+        return port > 0 && port <= 65535 && inet_pton(AF_INET, ip.c_str(), &addr) == 1;
+    }
+
     static bool bindSocket(int sockfd, const std::string& ip, int port) {
         struct sockaddr_in addr;
         memset(&addr, 0, sizeof(addr));
@@ -48,35 +131,261 @@ class NetworkUtils {
         return true;
     }
 
-    static bool sendMessage(int sockfd, const Message& msg, const std::string& ip, int port) {
-        struct sockaddr_in addr;
-        memset(&addr, 0, sizeof(addr));
-        addr.sin_family = AF_INET;
-        addr.sin_port = htons(port);
-        inet_pton(AF_INET, ip.c_str(), &addr.sin_addr);
+    static size_t encodeMessage(const Message& msg, char* buf, WireFormat format = WIRE_COMPACT) {
+        if (format == WIRE_LEGACY) {
+            memcpy(buf, &msg, LEGACY_MESSAGE_SIZE);
+            return LEGACY_MESSAGE_SIZE;
+        }
 
-        ssize_t sent =
-            sendto(sockfd, &msg, sizeof(Message), 0, (struct sockaddr*)&addr, sizeof(addr));
+        uint8_t* out = reinterpret_cast<uint8_t*>(buf);
+        size_t data_len = payloadLength(msg);
 
-        return sent == sizeof(Message);
-    }
+        uint8_t fields = 0;
+        fields |= msg.client_id != 0 ? WIRE_CLIENT_ID : 0;
+        fields |= msg.target_id != 0 ? WIRE_TARGET_ID : 0;
+        fields |= msg.program_id != 0 ? WIRE_PROGRAM_ID : 0;
+        fields |= msg.reviewer_id != 0 ? WIRE_REVIEWER_ID : 0;
+        fields |= msg.result != CORRECT ? WIRE_RESULT : 0;
+        fields |= msg.state != WRITING ? WIRE_STATE : 0;
+        fields |= data_len > 0 ? WIRE_DATA : 0;
+        fields |= msg.timestamp != 0 ? WIRE_TIMESTAMP : 0;
+
+        out[0] = WIRE_MAGIC;
+        out[1] = WIRE_VERSION;
+        out[2] = static_cast<uint8_t>(msg.type) | (msg.ack != 0 ? WIRE_RELIABLE : 0);
+        out[3] = fields;
+
+        size_t pos = WIRE_HEADER_SIZE;
+        if (msg.ack != 0) {
+            pos += putVarint(out + pos, msg.seq);
+            pos += putVarint(out + pos, msg.ack);
+            pos += putVarint(out + pos, msg.ack_mask);
+        }
+        if (fields & WIRE_CLIENT_ID) {
+            pos += putVarint(out + pos, zigzag(msg.client_id));
+        }
+        if (fields & WIRE_TARGET_ID) {
+            pos += putVarint(out + pos, zigzag(msg.target_id));
+        }
+        if (fields & WIRE_PROGRAM_ID) {
+            pos += putVarint(out + pos, zigzag(msg.program_id));
+        }
+        if (fields & WIRE_REVIEWER_ID) {
+            pos += putVarint(out + pos, zigzag(msg.reviewer_id));
+        }
+        if (fields & WIRE_RESULT) {
+            pos += putVarint(out + pos, zigzag(msg.result));
+        }
+        if (fields & WIRE_STATE) {
+            pos += putVarint(out + pos, zigzag(msg.state));
+        }
+        if (fields & WIRE_DATA) {
+            pos += putVarint(out + pos, data_len);
+            memcpy(out + pos, msg.data, data_len);
+            pos += data_len;
+        }
+        if (fields & WIRE_TIMESTAMP) {
+            pos += putVarint(out + pos, zigzag(static_cast<int64_t>(msg.timestamp)));
+        }
 
-    static bool receiveMessage(int sockfd, Message& msg, std::string& from_ip, int& from_port) {
-        struct sockaddr_in from_addr;
-        socklen_t from_len = sizeof(from_addr);
+        return pos;
+    }
 
-        ssize_t received =
-            recvfrom(sockfd, &msg, sizeof(Message), 0, (struct sockaddr*)&from_addr, &from_len);
+    static bool decodeMessage(const char* buf,
+                              size_t len,
+                              Message& msg,
+                              WireFormat* format = nullptr) {
+        const uint8_t* in = reinterpret_cast<const uint8_t*>(buf);
+        const uint8_t* end = in + len;
 
-        if (received == sizeof(Message)) {
-            char ip_str[INET_ADDRSTRLEN];
-            inet_ntop(AF_INET, &from_addr.sin_addr, ip_str, INET_ADDRSTRLEN);
-            from_ip = ip_str;
-            from_port = ntohs(from_addr.sin_port);
+        if (len == 0 || in[0] != WIRE_MAGIC) {
+            if (len != LEGACY_MESSAGE_SIZE) {
+                return false;
+            }
+            memcpy(static_cast<void*>(&msg), buf, LEGACY_MESSAGE_SIZE);
+            msg.seq = 0;
+            msg.ack = 0;
+            msg.ack_mask = 0;
+            if (format) {
+                *format = WIRE_LEGACY;
+            }
             return true;
         }
 
-        return false;
+        if (len < WIRE_HEADER_SIZE || in[1] != WIRE_VERSION) {
+            return false;
+        }
+
+        uint8_t fields = in[3];
+        uint64_t values[6] = {0, 0, 0, 0, zigzag(CORRECT), zigzag(WRITING)};
+        const uint8_t* pos = in + WIRE_HEADER_SIZE;
+
+        uint64_t seq = 0, ack = 0, ack_mask = 0;
+        if ((in[2] & WIRE_RELIABLE) &&
+            (!getVarint(pos, end, seq) || !getVarint(pos, end, ack) ||
+             !getVarint(pos, end, ack_mask))) {
+            return false;
+        }
+
+        for (int i = 0; i < 6; i++) {
+            if ((fields & (1 << i)) && !getVarint(pos, end, values[i])) {
+                return false;
+            }
+        }
+
+        uint64_t data_len = 0;
+        if ((fields & WIRE_DATA) &&
+            (!getVarint(pos, end, data_len) || data_len >= sizeof(msg.data) ||
+             data_len > static_cast<uint64_t>(end - pos))) {
+            return false;
+        }
+        const uint8_t* data = pos;
+        pos += data_len;
+
+        uint64_t timestamp = 0;
+        if ((fields & WIRE_TIMESTAMP) && !getVarint(pos, end, timestamp)) {
+            return false;
+        }
+
+        msg.type = static_cast<MessageType>(in[2] & ~WIRE_RELIABLE);
+        msg.client_id = static_cast<int>(unzigzag(values[0]));
+        msg.target_id = static_cast<int>(unzigzag(values[1]));
+        msg.program_id = static_cast<int>(unzigzag(values[2]));
+        msg.reviewer_id = static_cast<int>(unzigzag(values[3]));
+        msg.result = static_cast<ReviewResult>(unzigzag(values[4]));
+        msg.state = static_cast<ProgrammerState>(unzigzag(values[5]));
+        memcpy(msg.data, data, data_len);
+        memset(msg.data + data_len, 0, sizeof(msg.data) - data_len);
+        msg.timestamp = static_cast<time_t>(unzigzag(timestamp));
+        msg.seq = static_cast<uint32_t>(seq);
+        msg.ack = static_cast<uint32_t>(ack);
+        msg.ack_mask = static_cast<uint32_t>(ack_mask);
+
+        if (format) {
+            *format = WIRE_COMPACT;
+        }
+        return true;
+    }
+
+    static bool sendMessage(int sockfd,
+                            const Message& msg,
+                            const Endpoint& to,
+                            WireFormat format = WIRE_COMPACT) {
+        char buf[BUFFER_SIZE];
+        size_t len = encodeMessage(msg, buf, format);
+
+        ssize_t sent = sendto(sockfd, buf, len, 0, to.data(), to.size());
+
+        return sent == static_cast<ssize_t>(len);
+    }
+
+    static bool receiveMessage(int sockfd,
+                               Message& msg,
+                               Endpoint& from,
+                               WireFormat* format = nullptr) {
+        char buf[BUFFER_SIZE];
+
+        while (true) {
+            socklen_t from_len = Endpoint::capacity();
+            ssize_t received = recvfrom(sockfd, buf, sizeof(buf), 0, from.data(), &from_len);
+            if (received < 0) {
+                return false;
+            }
+
+            if (decodeMessage(buf, static_cast<size_t>(received), msg, format)) {
+                from.resize(from_len);
+                return true;
+            }
+        }
+    }
+
+    static int receiveMessages(int sockfd,
+                               std::vector<Message>& msgs,
+                               std::vector<Endpoint>& from,
+                               std::vector<WireFormat>* formats = nullptr,
+                               DatagramTap* tap = nullptr) {
+        size_t count = msgs.size();
+        from.resize(count);
+        if (formats) {
+            formats->resize(count);
+        }
+
+        BatchScratch& scratch = batchScratch(count);
+
+        for (size_t i = 0; i < count; i++) {
+            scratch.iovecs[i].iov_base = &scratch.buffers[i * BUFFER_SIZE];
+            scratch.iovecs[i].iov_len = BUFFER_SIZE;
+            memset(&scratch.headers[i], 0, sizeof(scratch.headers[i]));
+            scratch.headers[i].msg_hdr.msg_iov = &scratch.iovecs[i];
+            scratch.headers[i].msg_hdr.msg_iovlen = 1;
+            scratch.headers[i].msg_hdr.msg_name = from[i].data();
+            scratch.headers[i].msg_hdr.msg_namelen = Endpoint::capacity();
+        }
+
+        int received = recvmmsg(sockfd, scratch.headers.data(), count, MSG_DONTWAIT, nullptr);
+        if (received <= 0) {
+            return 0;
+        }
+
+        int valid = 0;
+        for (int i = 0; i < received; i++) {
+            WireFormat format;
+            const struct msghdr& header = scratch.headers[i].msg_hdr;
+            const char* buf = &scratch.buffers[i * BUFFER_SIZE];
+            if (tap) {
+                from[i].resize(header.msg_namelen);
+                tap->capture(buf,
+                             scratch.headers[i].msg_len,
+                             (header.msg_flags & MSG_TRUNC) != 0,
+                             from[i]);
+            }
+            if ((header.msg_flags & MSG_TRUNC) ||
+                !decodeMessage(buf, scratch.headers[i].msg_len, msgs[valid], &format)) {
+                continue;
+            }
+
+            if (valid != i) {
+                from[valid] = from[i];
+            }
+            from[valid].resize(header.msg_namelen);
+            if (formats) {
+                (*formats)[valid] = format;
+            }
+            valid++;
+        }
+
+        return valid;
+    }
+
+    static int sendMessages(int sockfd,
+                            const std::vector<Message>& msgs,
+                            const std::vector<Endpoint>& to,
+                            const std::vector<WireFormat>* formats = nullptr) {
+        size_t count = std::min(msgs.size(), to.size());
+        BatchScratch& scratch = batchScratch(count);
+
+        for (size_t i = 0; i < count; i++) {
+            WireFormat format = formats ? (*formats)[i] : WIRE_COMPACT;
+            char* buf = &scratch.buffers[i * BUFFER_SIZE];
+            scratch.iovecs[i].iov_base = buf;
+            scratch.iovecs[i].iov_len = encodeMessage(msgs[i], buf, format);
+            memset(&scratch.headers[i], 0, sizeof(scratch.headers[i]));
+            scratch.headers[i].msg_hdr.msg_iov = &scratch.iovecs[i];
+            scratch.headers[i].msg_hdr.msg_iovlen = 1;
+            scratch.headers[i].msg_hdr.msg_name = const_cast<struct sockaddr*>(to[i].data());
+            scratch.headers[i].msg_hdr.msg_namelen = to[i].size();
+        }
+
+        size_t sent = 0;
+        while (sent < count) {
+            int n = sendmmsg(sockfd, scratch.headers.data() + sent, count - sent, 0);
+            if (n <= 0) {
+                break;
+            }
+            sent += n;
+        }
+
+        return static_cast<int>(sent);
     }
 
     static std::string getCurrentTime() {
@@ -91,46 +400,112 @@ class NetworkUtils {
 
     static void printMessage(const std::string& prefix, const Message& msg) {
         std::cout << "[" << getCurrentTime() << "] " << prefix;
+        describeMessage(std::cout, msg);
+        std::cout << std::endl;
+    }
 
+    static void describeMessage(std::ostream& out, const Message& msg) {
         switch (msg.type) {
             case REGISTER_PROGRAMMER:
-                std::cout << "REGISTER_PROGRAMMER from client " << msg.client_id;
+                out << "REGISTER_PROGRAMMER from client " << msg.client_id;
                 break;
             case REGISTER_OBSERVER:
-                std::cout << "REGISTER_OBSERVER from client " << msg.client_id;
+                out << "REGISTER_OBSERVER from client " << msg.client_id;
                 break;
             case SUBMIT_PROGRAM:
-                std::cout << "SUBMIT_PROGRAM " << msg.program_id << " from " << msg.client_id
-                          << " to " << msg.target_id;
+                out << "SUBMIT_PROGRAM " << msg.program_id << " from " << msg.client_id
+                    << " to " << msg.target_id;
                 break;
             case REQUEST_REVIEW:
-                std::cout << "REQUEST_REVIEW from " << msg.client_id;
+                out << "REQUEST_REVIEW from " << msg.client_id;
                 break;
             case REVIEW_RESULT:
-                std::cout << "REVIEW_RESULT for program " << msg.program_id << " - "
-                          << (msg.result == CORRECT ? "CORRECT" : "INCORRECT");
+                out << "REVIEW_RESULT for program " << msg.program_id << " - "
+                    << (msg.result == CORRECT ? "CORRECT" : "INCORRECT");
                 break;
             case STATUS_UPDATE:
-                std::cout << "STATUS_UPDATE for client " << msg.client_id;
+                out << "STATUS_UPDATE for client " << msg.client_id;
                 break;
             case DISCONNECT:
-                std::cout << "DISCONNECT from client " << msg.client_id;
+                out << "DISCONNECT from client " << msg.client_id;
                 break;
             case SHUTDOWN:
-                std::cout << "SHUTDOWN command";
+                out << "SHUTDOWN command";
                 break;
             case HEARTBEAT:
-                std::cout << "HEARTBEAT from client " << msg.client_id;
+                out << "HEARTBEAT from client " << msg.client_id;
+                break;
+            case STATUS_RESYNC:
+                out << "STATUS_RESYNC from client " << msg.client_id;
+                break;
+            case ACK:
+                out << "ACK " << msg.ack << " from client " << msg.client_id;
+                break;
+            case REVIEW_CREDIT:
+                out << "REVIEW_CREDIT " << msg.program_id << " from client " << msg.client_id;
                 break;
             default:
-                std::cout << "Unknown message type " << msg.type;
+                out << "Unknown message type " << msg.type;
         }
 
-        if (strlen(msg.data) > 0) {
-            std::cout << " - " << msg.data;
+        if (!hasBinaryPayload(msg.type) && strlen(msg.data) > 0) {
+            out << " - " << msg.data;
         }
+    }
 
-        std::cout << std::endl;
+    static size_t payloadLength(const Message& msg) {
+        if (hasBinaryPayload(msg.type)) {
+            size_t len = 1 + static_cast<uint8_t>(msg.data[0]);
+            return std::min(len, sizeof(msg.data) - 1);
+        }
+        return strnlen(msg.data, sizeof(msg.data) - 1);
+    }
+
+    static uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    static int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    static size_t putVarint(uint8_t* out, uint64_t value) {
+        size_t len = 0;
+        while (value >= 0x80) {
+            out[len++] = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        out[len++] = static_cast<uint8_t>(value);
+        return len;
+    }
+
+    static bool getVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+            uint8_t byte = *pos++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+   private:
+    struct BatchScratch {
+        std::vector<struct mmsghdr> headers;
+        std::vector<struct iovec> iovecs;
+        std::vector<char> buffers;
+    };
+
+    static BatchScratch& batchScratch(size_t count) {
+        thread_local BatchScratch scratch;
+        if (scratch.headers.size() < count) {
+            scratch.headers.resize(count);
+            scratch.iovecs.resize(count);
+            scratch.buffers.resize(count * BUFFER_SIZE);
+        }
+        return scratch;
     }
 };
 
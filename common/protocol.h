@@ -1,6 +1,8 @@
 #ifndef PROTOCOL_H
 #define PROTOCOL_H
 
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <ctime>
 #include <string>
@@ -15,13 +17,40 @@ enum MessageType {
     DISCONNECT = 7,
     SHUTDOWN = 8,
     HEARTBEAT = 9,
-    ASSIGNMENT_NOTIFICATION = 10
+    ASSIGNMENT_NOTIFICATION = 10,
+    STATUS_SNAPSHOT = 11,
+    STATUS_DELTA = 12,
+    STATUS_RESYNC = 13,
+    ACK = 14,
+    REVIEW_CREDIT = 15
 };
 
 enum ProgrammerState { WRITING = 1, WAITING_REVIEW = 2, REVIEWING = 3, FIXING = 4, SLEEPING = 5 };
 
 enum ReviewResult { CORRECT = 1, INCORRECT = 2 };
 
+enum WireFormat { WIRE_LEGACY = 0, WIRE_COMPACT = 1 };
+
+enum WireField {
+    WIRE_CLIENT_ID = 1 << 0,
+    WIRE_TARGET_ID = 1 << 1,
+    WIRE_PROGRAM_ID = 1 << 2,
+    WIRE_REVIEWER_ID = 1 << 3,
+    WIRE_RESULT = 1 << 4,
+    WIRE_STATE = 1 << 5,
+    WIRE_DATA = 1 << 6,
+    WIRE_TIMESTAMP = 1 << 7
+};
+
+inline bool hasBinaryPayload(MessageType type) {
+    return type == STATUS_SNAPSHOT || type == STATUS_DELTA;
+}
+
+const unsigned char WIRE_MAGIC = 0xC7;
+const unsigned char WIRE_VERSION = 1;
+const size_t WIRE_HEADER_SIZE = 4;
+const unsigned char WIRE_RELIABLE = 0x80;
+
 struct Message {
     MessageType type;
     int client_id;
@@ -32,6 +61,9 @@ struct Message {
     ProgrammerState state;
     char data[256];
     time_t timestamp;
+    uint32_t seq;
+    uint32_t ack;
+    uint32_t ack_mask;
 
     Message()
         : type(HEARTBEAT),
@@ -41,11 +73,16 @@ struct Message {
           reviewer_id(0),
           result(CORRECT),
           state(WRITING),
-          timestamp(time(nullptr)) {
+          timestamp(time(nullptr)),
+          seq(0),
+          ack(0),
+          ack_mask(0) {
         memset(data, 0, sizeof(data));
     }
 };
 
+const size_t LEGACY_MESSAGE_SIZE = offsetof(Message, seq);
+
 struct ProgramReview {
     int program_id;
     int author_id;
@@ -95,9 +132,13 @@ struct ProgrammerInfo {
           is_connected(true) {}
 };
 
-const int MAX_PROGRAMMERS = 10;
 const int HEARTBEAT_INTERVAL = 5;
 const int CLIENT_TIMEOUT = 15;
 const int BUFFER_SIZE = 512;
+const int STATUS_STREAM_VERSION = 1;
+const int ANY_REVIEWER = 0;
+const int FIRST_OBSERVER_ID = -1;
+const int REVIEW_WINDOW = 1;
+const int REVIEW_RESEND_MS = 1000;
 
 #endif
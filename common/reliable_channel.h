@@ -0,0 +1,310 @@
+#ifndef RELIABLE_CHANNEL_H
+#define RELIABLE_CHANNEL_H
+
+#include <time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "endpoint.h"
+#include "protocol.h"
+
+class ReliableChannel {
+   public:
+    typedef Endpoint Peer;
+
+    struct Outgoing {
+        Message msg;
+        Peer peer;
+
+        Outgoing(const Message& message, const Peer& to) : msg(message), peer(to) {}
+    };
+
+    static const uint32_t RECEIVE_WINDOW = 32;
+    static const int INITIAL_RTO_MS = 500;
+    static const int MIN_RTO_MS = 100;
+    static const int MAX_RTO_MS = 5000;
+    static const int MAX_RETRIES = 8;
+
+    ReliableChannel() : local_id(0), retransmitted(0), duplicates(0), expired(0) {}
+
+    static bool isCritical(MessageType type) {
+        return type == SUBMIT_PROGRAM || type == REQUEST_REVIEW || type == REVIEW_RESULT ||
+               type == ASSIGNMENT_NOTIFICATION;
+    }
+
+    static uint64_t monotonicMs() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+    }
+
+    void setLocalId(int id) { local_id = id; }
+
+    bool knows(const Peer& peer) const {
+        return !peers.empty() && peers.find(peer) != peers.end();
+    }
+
+    void stamp(Message& msg, const Peer& peer, uint64_t now_ms) {
+        PeerState& state = peers[peer];
+
+        msg.ack = state.expected;
+        msg.ack_mask = state.received_mask;
+        msg.seq = 0;
+        state.ack_pending = false;
+
+        if (isCritical(msg.type)) {
+            msg.seq = state.next_seq++;
+            Pending& pending = state.unacked[msg.seq];
+            pending.msg = msg;
+            pending.sent_ms = now_ms;
+            pending.deadline_ms = now_ms + state.rto_ms;
+            pending.retries = 0;
+            active.insert(peer);
+        }
+    }
+
+    bool accept(const Message& msg, const Peer& peer, uint64_t now_ms) {
+        if (msg.ack == 0) {
+            return true;
+        }
+
+        PeerState& state = peers[peer];
+        handleAck(state, msg.ack, msg.ack_mask, now_ms);
+
+        if (msg.type == ACK) {
+            return false;
+        }
+        if (msg.seq == 0) {
+            return true;
+        }
+
+        state.ack_pending = true;
+        active.insert(peer);
+
+        if (msg.seq < state.expected) {
+            duplicates++;
+            return false;
+        }
+
+        if (msg.seq == state.expected) {
+            state.expected++;
+            while (state.received_mask & 1) {
+                state.received_mask >>= 1;
+                state.expected++;
+            }
+            state.received_mask >>= 1;
+            return true;
+        }
+
+        uint32_t offset = msg.seq - state.expected - 1;
+        if (offset >= RECEIVE_WINDOW) {
+            return false;
+        }
+
+        uint32_t bit = 1u << offset;
+        if (state.received_mask & bit) {
+            duplicates++;
+            return false;
+        }
+
+        state.received_mask |= bit;
+        return true;
+    }
+
+    void poll(uint64_t now_ms, std::vector<Outgoing>& out) {
+        for (auto peer = active.begin(); peer != active.end();) {
+            auto found = peers.find(*peer);
+            if (found == peers.end()) {
+                peer = active.erase(peer);
+                continue;
+            }
+            PeerState& state = found->second;
+
+            for (auto it = state.unacked.begin(); it != state.unacked.end();) {
+                Pending& pending = it->second;
+                if (pending.deadline_ms > now_ms) {
+                    ++it;
+                    continue;
+                }
+
+                if (pending.retries >= MAX_RETRIES) {
+                    expired++;
+                    it = state.unacked.erase(it);
+                    continue;
+                }
+
+                pending.retries++;
+                pending.deadline_ms = now_ms + backoff(state.rto_ms, pending.retries);
+                pending.msg.ack = state.expected;
+                pending.msg.ack_mask = state.received_mask;
+                out.push_back(Outgoing(pending.msg, *peer));
+                state.ack_pending = false;
+                retransmitted++;
+                ++it;
+            }
+
+            if (state.ack_pending) {
+                Message ack;
+                ack.type = ACK;
+                ack.client_id = local_id;
+                ack.ack = state.expected;
+                ack.ack_mask = state.received_mask;
+                out.push_back(Outgoing(ack, *peer));
+                state.ack_pending = false;
+            }
+
+            if (state.unacked.empty()) {
+                peer = active.erase(peer);
+            } else {
+                ++peer;
+            }
+        }
+    }
+
+    int nextTimeoutMs(uint64_t now_ms) const {
+        int timeout = -1;
+
+        for (const Peer& peer : active) {
+            auto found = peers.find(peer);
+            if (found == peers.end()) {
+                continue;
+            }
+
+            const PeerState& state = found->second;
+            if (state.ack_pending) {
+                return 0;
+            }
+
+            for (const auto& entry : state.unacked) {
+                uint64_t deadline = entry.second.deadline_ms;
+                int wait = deadline > now_ms ? static_cast<int>(deadline - now_ms) : 0;
+                if (timeout < 0 || wait < timeout) {
+                    timeout = wait;
+                }
+            }
+        }
+
+        return timeout;
+    }
+
+    void forget(const Peer& peer) {
+        peers.erase(peer);
+        active.erase(peer);
+    }
+
+    void bind(const Peer& peer, int id) { peers[peer].bound_id = id; }
+
+    int boundId(const Peer& peer) const {
+        auto it = peers.find(peer);
+        return it != peers.end() ? it->second.bound_id : 0;
+    }
+
+    size_t unackedCount() const {
+        size_t count = 0;
+        for (const auto& pair : peers) {
+            count += pair.second.unacked.size();
+        }
+        return count;
+    }
+
+    size_t retransmittedCount() const { return retransmitted; }
+    size_t duplicateCount() const { return duplicates; }
+    size_t expiredCount() const { return expired; }
+
+   private:
+    struct Pending {
+        Message msg;
+        uint64_t sent_ms;
+        uint64_t deadline_ms;
+        int retries;
+    };
+
+    struct PeerState {
+        uint32_t next_seq;
+        uint32_t expected;
+        uint32_t received_mask;
+        bool ack_pending;
+        bool rtt_valid;
+        double srtt_ms;
+        double rttvar_ms;
+        int rto_ms;
+        int bound_id;
+        std::map<uint32_t, Pending> unacked;
+
+        PeerState()
+            : next_seq(1),
+              expected(1),
+              received_mask(0),
+              ack_pending(false),
+              rtt_valid(false),
+              srtt_ms(0),
+              rttvar_ms(0),
+              rto_ms(INITIAL_RTO_MS),
+              bound_id(0) {}
+    };
+
+    static int backoff(int rto_ms, int retries) {
+        int shift = std::min(retries, 6);
+        return std::min(rto_ms << shift, static_cast<int>(MAX_RTO_MS));
+    }
+
+    void handleAck(PeerState& state, uint32_t ack, uint32_t mask, uint64_t now_ms) {
+        uint32_t highest_selective = 0;
+
+        for (auto it = state.unacked.begin(); it != state.unacked.end();) {
+            uint32_t seq = it->first;
+            bool acked = seq < ack;
+            if (!acked && seq > ack && seq - ack - 1 < RECEIVE_WINDOW) {
+                acked = (mask >> (seq - ack - 1)) & 1;
+                if (acked) {
+                    highest_selective = seq;
+                }
+            }
+
+            if (!acked) {
+                ++it;
+                continue;
+            }
+
+            if (it->second.retries == 0) {
+                sampleRtt(state, static_cast<double>(now_ms - it->second.sent_ms));
+            }
+            it = state.unacked.erase(it);
+        }
+
+        for (auto& entry : state.unacked) {
+            if (entry.first < highest_selective && entry.second.retries == 0) {
+                entry.second.deadline_ms = now_ms;
+            }
+        }
+    }
+
+    void sampleRtt(PeerState& state, double rtt_ms) {
+        if (!state.rtt_valid) {
+            state.srtt_ms = rtt_ms;
+            state.rttvar_ms = rtt_ms / 2;
+            state.rtt_valid = true;
+        } else {
+            state.rttvar_ms = 0.75 * state.rttvar_ms + 0.25 * std::abs(state.srtt_ms - rtt_ms);
+            state.srtt_ms = 0.875 * state.srtt_ms + 0.125 * rtt_ms;
+        }
+
+        int rto = static_cast<int>(state.srtt_ms + 4 * state.rttvar_ms);
+        state.rto_ms = std::max(static_cast<int>(MIN_RTO_MS),
+                                std::min(rto, static_cast<int>(MAX_RTO_MS)));
+    }
+
+    std::map<Peer, PeerState> peers;
+    std::set<Peer> active;
+    int local_id;
+    size_t retransmitted;
+    size_t duplicates;
+    size_t expired;
+};
+
+#endif
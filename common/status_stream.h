@@ -0,0 +1,147 @@
+#ifndef STATUS_STREAM_H
+#define STATUS_STREAM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "network_utils.h"
+#include "protocol.h"
+
+struct StatusRecord {
+    ProgrammerInfo info;
+    size_t queue_depth;
+
+    StatusRecord() : queue_depth(0) {}
+
+    StatusRecord(const ProgrammerInfo& programmer, size_t queued)
+        : info(programmer), queue_depth(queued) {}
+};
+
+struct StatusFrame {
+    uint32_t sequence;
+    uint32_t total;
+    std::vector<StatusRecord> records;
+
+    StatusFrame() : sequence(0), total(0) {}
+};
+
+class StatusStream {
+   public:
+    static const size_t MAX_NAME_BYTES = 64;
+    static const size_t MAX_ACTIVITY_BYTES = 128;
+
+    static void beginFrame(Message& msg,
+                           MessageType type,
+                           int observer_id,
+                           uint32_t sequence,
+                           uint32_t total) {
+        msg.type = type;
+        msg.client_id = observer_id;
+        memset(msg.data, 0, sizeof(msg.data));
+
+        uint8_t* payload = reinterpret_cast<uint8_t*>(msg.data);
+        size_t len = NetworkUtils::putVarint(payload + 1, sequence);
+        len += NetworkUtils::putVarint(payload + 1 + len, total);
+        payload[0] = static_cast<uint8_t>(len);
+    }
+
+    static bool appendRecord(Message& msg, const ProgrammerInfo& info, size_t queue_depth) {
+        uint8_t record[sizeof(msg.data)];
+        size_t len = 0;
+
+        len += NetworkUtils::putVarint(record + len, NetworkUtils::zigzag(info.id));
+        len += NetworkUtils::putVarint(record + len, info.state);
+        record[len++] = info.is_connected ? 1 : 0;
+        len += NetworkUtils::putVarint(record + len, info.programs_written);
+        len += NetworkUtils::putVarint(record + len, info.programs_reviewed);
+        len += NetworkUtils::putVarint(record + len, NetworkUtils::zigzag(info.current_program_id));
+        len += NetworkUtils::putVarint(record + len, queue_depth);
+        len += putString(record + len, info.name, MAX_NAME_BYTES);
+        len += putString(record + len, info.current_activity, MAX_ACTIVITY_BYTES);
+
+        uint8_t* payload = reinterpret_cast<uint8_t*>(msg.data);
+        size_t used = payload[0];
+        if (1 + used + len > sizeof(msg.data) - 1) {
+            return false;
+        }
+
+        memcpy(payload + 1 + used, record, len);
+        payload[0] = static_cast<uint8_t>(used + len);
+        return true;
+    }
+
+    static bool parseFrame(const Message& msg, StatusFrame& frame) {
+        const uint8_t* payload = reinterpret_cast<const uint8_t*>(msg.data);
+        size_t len = std::min<size_t>(payload[0], sizeof(msg.data) - 1);
+        const uint8_t* pos = payload + 1;
+        const uint8_t* end = pos + len;
+
+        uint64_t sequence, total;
+        if (!NetworkUtils::getVarint(pos, end, sequence) ||
+            !NetworkUtils::getVarint(pos, end, total)) {
+            return false;
+        }
+
+        frame.sequence = static_cast<uint32_t>(sequence);
+        frame.total = static_cast<uint32_t>(total);
+        frame.records.clear();
+
+        while (pos < end) {
+            uint64_t id, state, written, reviewed, program_id, queued;
+            StatusRecord record;
+
+            if (!NetworkUtils::getVarint(pos, end, id) ||
+                !NetworkUtils::getVarint(pos, end, state) || pos >= end) {
+                return false;
+            }
+            record.info.is_connected = *pos++ != 0;
+
+            if (!NetworkUtils::getVarint(pos, end, written) ||
+                !NetworkUtils::getVarint(pos, end, reviewed) ||
+                !NetworkUtils::getVarint(pos, end, program_id) ||
+                !NetworkUtils::getVarint(pos, end, queued) ||
+                !getString(pos, end, record.info.name) ||
+                !getString(pos, end, record.info.current_activity)) {
+                return false;
+            }
+
+            record.info.id = static_cast<int>(NetworkUtils::unzigzag(id));
+            record.info.state = static_cast<ProgrammerState>(state);
+            record.info.programs_written = static_cast<int>(written);
+            record.info.programs_reviewed = static_cast<int>(reviewed);
+            record.info.current_program_id = static_cast<int>(NetworkUtils::unzigzag(program_id));
+            record.queue_depth = static_cast<size_t>(queued);
+            frame.records.push_back(record);
+        }
+
+        return true;
+    }
+
+   private:
+    static size_t putString(uint8_t* out, const std::string& value, size_t max_bytes) {
+        size_t len = std::min(value.size(), max_bytes);
+        while (len > 0 && len < value.size() && (static_cast<uint8_t>(value[len]) & 0xC0) == 0x80) {
+            len--;
+        }
+
+        size_t header = NetworkUtils::putVarint(out, len);
+        memcpy(out + header, value.data(), len);
+        return header + len;
+    }
+
+    static bool getString(const uint8_t*& pos, const uint8_t* end, std::string& value) {
+        uint64_t len;
+        if (!NetworkUtils::getVarint(pos, end, len) || len > static_cast<uint64_t>(end - pos)) {
+            return false;
+        }
+
+        value.assign(reinterpret_cast<const char*>(pos), static_cast<size_t>(len));
+        pos += len;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "endpoint.h"
+#include "network_utils.h"
+#include "protocol.h"
+
+class Transport {
+   public:
+    Transport() : tap(nullptr) {}
+
+    virtual ~Transport() {}
+
+    virtual int pollFd() const = 0;
+
+    virtual int receiveMessages(std::vector<Message>& msgs, std::vector<Endpoint>& from) = 0;
+
+    virtual bool sendMessage(const Message& msg, const Endpoint& to) = 0;
+
+    virtual int sendMessages(const std::vector<Message>& msgs,
+                             const std::vector<Endpoint>& to) = 0;
+
+    virtual void flush() {}
+
+    void setTap(DatagramTap* datagram_tap) { tap = datagram_tap; }
+
+    WireFormat peerFormat(const Endpoint& peer) const {
+        if (legacy_peers.empty()) {
+            return WIRE_COMPACT;
+        }
+        return legacy_peers.count(peer) ? WIRE_LEGACY : WIRE_COMPACT;
+    }
+
+    void notePeerFormat(const Endpoint& peer, WireFormat format) {
+        if (format == WIRE_LEGACY) {
+            legacy_peers.insert(peer);
+        } else if (!legacy_peers.empty()) {
+            legacy_peers.erase(peer);
+        }
+    }
+
+   protected:
+    std::set<Endpoint> legacy_peers;
+    DatagramTap* tap;
+};
+
+class SocketTransport : public Transport {
+   public:
+    explicit SocketTransport(int fd) : sockfd(fd) {}
+
+    int pollFd() const override { return sockfd; }
+
+    int receiveMessages(std::vector<Message>& msgs, std::vector<Endpoint>& from) override {
+        int count = NetworkUtils::receiveMessages(sockfd, msgs, from, &formats, tap);
+        for (int i = 0; i < count; i++) {
+            notePeerFormat(from[i], formats[i]);
+        }
+        return count;
+    }
+
+    bool sendMessage(const Message& msg, const Endpoint& to) override {
+        return NetworkUtils::sendMessage(sockfd, msg, to, peerFormat(to));
+    }
+
+    int sendMessages(const std::vector<Message>& msgs, const std::vector<Endpoint>& to) override {
+        if (legacy_peers.empty()) {
+            return NetworkUtils::sendMessages(sockfd, msgs, to);
+        }
+
+        formats.resize(to.size());
+        for (size_t i = 0; i < to.size(); i++) {
+            formats[i] = peerFormat(to[i]);
+        }
+        return NetworkUtils::sendMessages(sockfd, msgs, to, &formats);
+    }
+
+   private:
+    int sockfd;
+    std::vector<WireFormat> formats;
+};
+
+class MemoryTransport : public Transport {
+   public:
+    MemoryTransport() : inbox_head(0) {}
+
+    int pollFd() const override { return -1; }
+
+    void deliver(const Message& msg, const Endpoint& from) {
+        inbox.push_back(msg);
+        inbox_sources.push_back(from);
+    }
+
+    bool deliverDatagram(const char* data, size_t length, const Endpoint& from) {
+        if (tap) {
+            tap->capture(data, length, false, from);
+        }
+
+        Message msg;
+        WireFormat format;
+        if (!NetworkUtils::decodeMessage(data, length, msg, &format)) {
+            return false;
+        }
+
+        notePeerFormat(from, format);
+        deliver(msg, from);
+        return true;
+    }
+
+    bool hasInbound() const { return inbox_head < inbox.size(); }
+
+    int receiveMessages(std::vector<Message>& msgs, std::vector<Endpoint>& from) override {
+        size_t count = std::min(msgs.size(), inbox.size() - inbox_head);
+        from.resize(msgs.size());
+        for (size_t i = 0; i < count; i++) {
+            msgs[i] = inbox[inbox_head + i];
+            from[i] = inbox_sources[inbox_head + i];
+        }
+
+        inbox_head += count;
+        if (inbox_head == inbox.size()) {
+            inbox.clear();
+            inbox_sources.clear();
+            inbox_head = 0;
+        }
+        return static_cast<int>(count);
+    }
+
+    bool sendMessage(const Message& msg, const Endpoint& to) override {
+        sent.push_back(msg);
+        sent_to.push_back(to);
+        return true;
+    }
+
+    int sendMessages(const std::vector<Message>& msgs, const std::vector<Endpoint>& to) override {
+        sent.insert(sent.end(), msgs.begin(), msgs.end());
+        sent_to.insert(sent_to.end(), to.begin(), to.end());
+        return static_cast<int>(msgs.size());
+    }
+
+    void takeSent(std::vector<Message>& msgs, std::vector<Endpoint>& to) {
+        msgs.swap(sent);
+        to.swap(sent_to);
+        sent.clear();
+        sent_to.clear();
+    }
+
+   private:
+    std::vector<Message> inbox;
+    std::vector<Endpoint> inbox_sources;
+    size_t inbox_head;
+    std::vector<Message> sent;
+    std::vector<Endpoint> sent_to;
+};
+
+#endif
@@ -0,0 +1,466 @@
+#ifndef URING_TRANSPORT_H
+#define URING_TRANSPORT_H
+
+#include <arpa/inet.h>
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "endpoint.h"
+#include "protocol.h"
+#include "transport.h"
+
+class UringTransport : public Transport {
+   public:
+    explicit UringTransport(int fd)
+        : sockfd(fd),
+          ring_fd(-1),
+          sq_ptr(nullptr),
+          cq_ptr(nullptr),
+          sqes(nullptr),
+          sq_map_size(0),
+          cq_map_size(0),
+          sqes_map_size(0),
+          buf_ring(nullptr),
+          buf_ring_size(0),
+          buffers(nullptr),
+          buffer_size(0),
+          recv_armed(false),
+          queued(0) {
+        memset(&params, 0, sizeof(params));
+        memset(&recv_hdr, 0, sizeof(recv_hdr));
+    }
+
+    ~UringTransport() {
+        if (sqes) {
+            munmap(sqes, sqes_map_size);
+        }
+        if (cq_ptr && cq_ptr != sq_ptr) {
+            munmap(cq_ptr, cq_map_size);
+        }
+        if (sq_ptr) {
+            munmap(sq_ptr, sq_map_size);
+        }
+        if (buf_ring) {
+            munmap(buf_ring, buf_ring_size);
+        }
+        free(buffers);
+        if (ring_fd >= 0) {
+            close(ring_fd);
+        }
+    }
+
+    bool init() {
+        ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+        if (ring_fd < 0) {
+            perror("io_uring_setup failed");
+            return false;
+        }
+
+        recv_hdr.msg_namelen = Endpoint::capacity();
+        if (!mapRings() || !registerBufferRing()) {
+            return false;
+        }
+
+        send_slots.resize(params.sq_entries);
+        for (unsigned i = 0; i < params.sq_entries; i++) {
+            free_slots.push_back(i);
+        }
+
+        return armReceive() && submit(0);
+    }
+
+    int pollFd() const override { return ring_fd; }
+
+    int receiveMessages(std::vector<Message>& msgs, std::vector<Endpoint>& from) override {
+        reap();
+
+        size_t count = std::min(msgs.size(), inbox.size());
+        from.resize(msgs.size());
+
+        for (size_t i = 0; i < count; i++) {
+            const InboxEntry& entry = inbox.front();
+            msgs[i] = entry.msg;
+            from[i] = entry.from;
+            notePeerFormat(from[i], entry.format);
+            inbox.pop_front();
+        }
+
+        if (!recv_armed) {
+            armReceive();
+            submit(0);
+        }
+
+        return static_cast<int>(count);
+    }
+
+    bool sendMessage(const Message& msg, const Endpoint& to) override {
+        return queueSend(msg, to, peerFormat(to));
+    }
+
+    int sendMessages(const std::vector<Message>& msgs, const std::vector<Endpoint>& to) override {
+        size_t count = std::min(msgs.size(), to.size());
+        int sent = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            if (sendMessage(msgs[i], to[i])) {
+                sent++;
+            }
+        }
+
+        return sent;
+    }
+
+    void flush() override {
+        if (queued > 0) {
+            submit(0);
+        }
+    }
+
+   private:
+    static const unsigned RING_ENTRIES = 256;
+    static const unsigned BUFFER_COUNT = 256;
+    static const uint16_t BUFFER_GROUP = 0;
+    static const uint64_t RECV_TAG = ~0ULL;
+
+    struct SendSlot {
+        char payload[::BUFFER_SIZE];
+        Endpoint to;
+        struct iovec iov;
+        struct msghdr hdr;
+    };
+
+    bool mapRings() {
+        sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_map_size = std::max(sq_map_size, cq_map_size);
+        }
+
+        sq_ptr = mmap(nullptr,
+                      sq_map_size,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE,
+                      ring_fd,
+                      IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) {
+            sq_ptr = nullptr;
+            perror("io_uring sq mmap failed");
+            return false;
+        }
+
+        if (single_mmap) {
+            cq_ptr = sq_ptr;
+        } else {
+            cq_ptr = mmap(nullptr,
+                          cq_map_size,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE,
+                          ring_fd,
+                          IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED) {
+                cq_ptr = nullptr;
+                perror("io_uring cq mmap failed");
+                return false;
+            }
+        }
+
+        sqes_map_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        void* sqes_ptr = mmap(nullptr,
+                              sqes_map_size,
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE,
+                              ring_fd,
+                              IORING_OFF_SQES);
+        if (sqes_ptr == MAP_FAILED) {
+            perror("io_uring sqe mmap failed");
+            return false;
+        }
+        sqes = static_cast<struct io_uring_sqe*>(sqes_ptr);
+
+        char* sq = static_cast<char*>(sq_ptr);
+        sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        char* cq = static_cast<char*>(cq_ptr);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        return true;
+    }
+
+    bool registerBufferRing() {
+        buf_ring_size = BUFFER_COUNT * sizeof(struct io_uring_buf);
+        void* ring = mmap(nullptr,
+                          buf_ring_size,
+                          PROT_READ | PROT_WRITE,
+                          MAP_ANONYMOUS | MAP_PRIVATE,
+                          -1,
+                          0);
+        if (ring == MAP_FAILED) {
+            perror("io_uring buffer ring mmap failed");
+            return false;
+        }
+        buf_ring = static_cast<struct io_uring_buf*>(ring);
+
+        struct io_uring_buf_reg reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring);
+        reg.ring_entries = BUFFER_COUNT;
+        reg.bgid = BUFFER_GROUP;
+
+        if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            perror("io_uring buffer ring registration failed");
+            return false;
+        }
+
+        buffer_size = sizeof(struct io_uring_recvmsg_out) + recv_hdr.msg_namelen +
+                      recv_hdr.msg_controllen + ::BUFFER_SIZE;
+        buffers = static_cast<char*>(malloc(BUFFER_COUNT * buffer_size));
+        if (!buffers) {
+            return false;
+        }
+
+        buf_tail = 0;
+        for (unsigned i = 0; i < BUFFER_COUNT; i++) {
+            addBuffer(static_cast<uint16_t>(i));
+        }
+        publishBuffers();
+
+        return true;
+    }
+
+    void addBuffer(uint16_t bid) {
+        struct io_uring_buf* buf = &buf_ring[buf_tail & (BUFFER_COUNT - 1)];
+        buf->addr = reinterpret_cast<uint64_t>(buffers + bid * buffer_size);
+        buf->len = static_cast<uint32_t>(buffer_size);
+        buf->bid = bid;
+        buf_tail++;
+    }
+
+    void publishBuffers() {
+        __atomic_store_n(&buf_ring[0].resv, buf_tail, __ATOMIC_RELEASE);
+    }
+
+    struct io_uring_sqe* nextSqe() {
+        unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+        unsigned tail = *sq_tail;
+
+        if (tail - head >= params.sq_entries) {
+            submit(0);
+            head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+            if (tail - head >= params.sq_entries) {
+                return nullptr;
+            }
+        }
+
+        unsigned index = tail & *sq_mask;
+        struct io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        queued++;
+
+        return sqe;
+    }
+
+    bool armReceive() {
+        struct io_uring_sqe* sqe = nextSqe();
+        if (!sqe) {
+            return false;
+        }
+
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->fd = sockfd;
+        sqe->addr = reinterpret_cast<uint64_t>(&recv_hdr);
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUFFER_GROUP;
+        sqe->user_data = RECV_TAG;
+
+        recv_armed = true;
+        return true;
+    }
+
+    struct InboxEntry {
+        Message msg;
+        Endpoint from;
+        WireFormat format;
+    };
+
+    bool queueSend(const Message& msg, const Endpoint& to, WireFormat format) {
+        if (free_slots.empty()) {
+            submit(1);
+            reap();
+            if (free_slots.empty()) {
+                return false;
+            }
+        }
+
+        unsigned slot_index = free_slots.back();
+        SendSlot& slot = send_slots[slot_index];
+
+        struct io_uring_sqe* sqe = nextSqe();
+        if (!sqe) {
+            return false;
+        }
+        free_slots.pop_back();
+
+        slot.to = to;
+        slot.iov.iov_base = slot.payload;
+        slot.iov.iov_len = NetworkUtils::encodeMessage(msg, slot.payload, format);
+        memset(&slot.hdr, 0, sizeof(slot.hdr));
+        slot.hdr.msg_name = slot.to.data();
+        slot.hdr.msg_namelen = slot.to.size();
+        slot.hdr.msg_iov = &slot.iov;
+        slot.hdr.msg_iovlen = 1;
+
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = sockfd;
+        sqe->addr = reinterpret_cast<uint64_t>(&slot.hdr);
+        sqe->len = 1;
+        sqe->user_data = slot_index;
+
+        if (queued >= params.sq_entries / 2) {
+            submit(0);
+        }
+
+        return true;
+    }
+
+    bool submit(unsigned wait_for) {
+        unsigned flags = wait_for > 0 ? IORING_ENTER_GETEVENTS : 0;
+        int ret = static_cast<int>(
+            syscall(__NR_io_uring_enter, ring_fd, queued, wait_for, flags, nullptr, 0));
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            perror("io_uring_enter failed");
+            return false;
+        }
+        if (ret > 0) {
+            queued -= std::min(queued, static_cast<unsigned>(ret));
+        }
+        return true;
+    }
+
+    void reap() {
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        bool returned_buffers = false;
+
+        while (head != tail) {
+            const struct io_uring_cqe& cqe = cqes[head & *cq_mask];
+
+            if (cqe.user_data == RECV_TAG) {
+                returned_buffers |= handleReceive(cqe);
+            } else {
+                free_slots.push_back(static_cast<unsigned>(cqe.user_data));
+            }
+
+            head++;
+        }
+
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+
+        if (returned_buffers) {
+            publishBuffers();
+        }
+    }
+
+    bool handleReceive(const struct io_uring_cqe& cqe) {
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+            recv_armed = false;
+        }
+
+        if (!(cqe.flags & IORING_CQE_F_BUFFER)) {
+            return false;
+        }
+
+        uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+
+        if (cqe.res > 0) {
+            const char* data = buffers + bid * buffer_size;
+            const struct io_uring_recvmsg_out* out =
+                reinterpret_cast<const struct io_uring_recvmsg_out*>(data);
+            const char* name = data + sizeof(*out);
+            const char* payload = name + recv_hdr.msg_namelen + recv_hdr.msg_controllen;
+            bool truncated = (out->flags & MSG_TRUNC) != 0;
+
+            InboxEntry entry;
+            if (out->namelen <= Endpoint::capacity()) {
+                memcpy(entry.from.data(), name, out->namelen);
+                entry.from.resize(out->namelen);
+
+                if (tap) {
+                    size_t available = static_cast<size_t>(cqe.res) - (payload - data);
+                    tap->capture(payload,
+                                 std::min<size_t>(out->payloadlen, available),
+                                 truncated,
+                                 entry.from);
+                }
+                if (!truncated &&
+                    NetworkUtils::decodeMessage(payload, out->payloadlen, entry.msg, &entry.format)) {
+                    inbox.push_back(entry);
+                }
+            }
+        }
+
+        addBuffer(bid);
+        return true;
+    }
+
+    int sockfd;
+    int ring_fd;
+    struct io_uring_params params;
+
+    void* sq_ptr;
+    void* cq_ptr;
+    struct io_uring_sqe* sqes;
+    size_t sq_map_size;
+    size_t cq_map_size;
+    size_t sqes_map_size;
+
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+
+    struct io_uring_buf* buf_ring;
+    size_t buf_ring_size;
+    char* buffers;
+    size_t buffer_size;
+    uint16_t buf_tail;
+
+    struct msghdr recv_hdr;
+    bool recv_armed;
+    unsigned queued;
+
+    std::vector<SendSlot> send_slots;
+    std::vector<unsigned> free_slots;
+    std::deque<InboxEntry> inbox;
+};
+
+#endif
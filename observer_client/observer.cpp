@@ -1,48 +1,85 @@
+#include <poll.h>
 #include <signal.h>
 #include <termios.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
+#include <deque>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <string>
 #include <thread>
 
 #include "../common/network_utils.h"
 #include "../common/protocol.h"
+#include "../common/status_stream.h"
+
+const size_t PENDING_DELTA_LIMIT = 4096;
+const int MESSAGE_POLL_MS = 100;
 
 class ObserverClient {
    private:
     int sockfd;
-    std::string server_ip;
-    int server_port;
+    int multicast_fd;
+    Endpoint server;
     int client_port;
+    std::string multicast_group;
+    int multicast_port;
+    std::string multicast_interface;
     int client_id;
     bool running;
     bool registered;
     std::string accumulated_status;
 
+    std::mutex model_mutex;
+    std::map<int, StatusRecord> model;
+    std::map<int, StatusRecord> snapshot_model;
+    std::deque<StatusFrame> pending_deltas;
+    bool synced;
+    bool snapshot_in_progress;
+    bool render_pending;
+    uint32_t last_sequence;
+    uint32_t snapshot_sequence;
+    std::chrono::steady_clock::time_point resync_requested;
+
     static ObserverClient* instance;
 
    public:
     ObserverClient(const std::string& server_ip, int server_port, int client_port)
-        : server_ip(server_ip),
-          server_port(server_port),
+        : sockfd(-1),
+          multicast_fd(-1),
+          server(server_ip, server_port),
           client_port(client_port),
+          multicast_port(0),
           client_id(0),
           running(false),
-          registered(false) {
+          registered(false),
+          synced(false),
+          snapshot_in_progress(false),
+          render_pending(false),
+          last_sequence(0),
+          snapshot_sequence(0),
+          resync_requested(std::chrono::steady_clock::now()) {
         instance = this;
         signal(SIGINT, signalHandler);
         signal(SIGTERM, signalHandler);
     }
 
-    static void signalHandler(int signal) {
+    static void signalHandler(int) {
         if (instance) {
             std::cout << "\nПолучен сигнал завершения..." << std::endl;
             instance->disconnect();
         }
     }
 
+    void useMulticast(const std::string& group, int port, const std::string& interface_ip) {
+        multicast_group = group;
+        multicast_port = port;
+        multicast_interface = interface_ip;
+    }
+
     bool start() {
         sockfd = NetworkUtils::createUDPSocket();
         if (sockfd < 0) {
@@ -56,7 +93,12 @@ class ObserverClient {
 
         std::cout << "Наблюдатель запущен на порту " << client_port << std::endl;
 
-        if (!registerWithServer()) {
+        if (!multicast_group.empty()) {
+            if (!joinMulticast()) {
+                close(sockfd);
+                return false;
+            }
+        } else if (!registerWithServer()) {
             close(sockfd);
             return false;
         }
@@ -84,34 +126,63 @@ class ObserverClient {
             msg.client_id = client_id;
             strcpy(msg.data, "Observer disconnecting");
 
-            NetworkUtils::sendMessage(sockfd, msg, server_ip, server_port);
+            NetworkUtils::sendMessage(sockfd, msg, server);
         }
 
         running = false;
         close(sockfd);
+        if (multicast_fd >= 0) {
+            close(multicast_fd);
+        }
     }
 
    private:
+    bool joinMulticast() {
+        multicast_fd = NetworkUtils::createUDPSocket();
+        if (multicast_fd < 0) {
+            return false;
+        }
+
+        if (!NetworkUtils::enableReuseAddr(multicast_fd) ||
+            !NetworkUtils::bindSocket(multicast_fd, multicast_group, multicast_port) ||
+            !NetworkUtils::joinMulticastGroup(multicast_fd, multicast_group, multicast_interface)) {
+            close(multicast_fd);
+            multicast_fd = -1;
+            return false;
+        }
+
+        std::cout << "Подписаны на multicast-группу " << multicast_group << ":" << multicast_port
+                  << std::endl;
+        std::cout << "\nДоступные команды:" << std::endl;
+        std::cout << "  q - выход" << std::endl;
+        std::cout << "  r - обновить статус" << std::endl;
+        std::cout << "  h - помощь" << std::endl;
+
+        requestResync();
+        return true;
+    }
+
     bool registerWithServer() {
         Message msg;
         msg.type = REGISTER_OBSERVER;
         msg.client_id = 0;
+        msg.target_id = STATUS_STREAM_VERSION;
         strcpy(msg.data, "Observer client");
 
-        if (!NetworkUtils::sendMessage(sockfd, msg, server_ip, server_port)) {
+        if (!NetworkUtils::sendMessage(sockfd, msg, server)) {
             std::cout << "Ошибка отправки регистрации на сервер" << std::endl;
             return false;
         }
 
-        std::string from_ip;
-        int from_port;
+        Endpoint from;
         auto start_time = std::chrono::steady_clock::now();
 
         while (std::chrono::steady_clock::now() - start_time < std::chrono::seconds(10)) {
-            if (NetworkUtils::receiveMessage(sockfd, msg, from_ip, from_port)) {
+            if (NetworkUtils::receiveMessage(sockfd, msg, from)) {
                 if (msg.type == REGISTER_OBSERVER) {
                     client_id = msg.client_id;
                     registered = true;
+                    resync_requested = std::chrono::steady_clock::now();
                     std::cout << "Зарегистрированы на сервере с ID: " << client_id << std::endl;
                     std::cout << "\nДоступные команды:" << std::endl;
                     std::cout << "  q - выход" << std::endl;
@@ -131,10 +202,29 @@ class ObserverClient {
     void messageLoop() {
         while (running) {
             processMessages();
-            usleep(100000);
+            if (render_pending) {
+                render_pending = false;
+                renderModel();
+            }
+            checkResync();
+            waitMessages();
         }
     }
 
+    void waitMessages() {
+        struct pollfd fds[2];
+        int count = 0;
+        for (int fd : {sockfd, multicast_fd}) {
+            if (fd >= 0) {
+                fds[count].fd = fd;
+                fds[count].events = POLLIN;
+                fds[count].revents = 0;
+                count++;
+            }
+        }
+        poll(fds, count, MESSAGE_POLL_MS);
+    }
+
     void inputLoop() {
         while (running) {
             char input = getchar();
@@ -149,7 +239,7 @@ class ObserverClient {
                 case 'r':
                 case 'R':
                     std::cout << "Запрос обновления статуса..." << std::endl;
-                    requestStatusUpdate();
+                    requestResync();
                     break;
 
                 case 'h':
@@ -158,7 +248,7 @@ class ObserverClient {
                     break;
 
                 case '\n':
-                    requestStatusUpdate();
+                    renderModel();
                     break;
 
                 default:
@@ -168,15 +258,27 @@ class ObserverClient {
     }
 
     void processMessages() {
+        processSocket(sockfd);
+        if (multicast_fd >= 0) {
+            processSocket(multicast_fd);
+        }
+    }
+
+    void processSocket(int fd) {
         Message msg;
-        std::string from_ip;
-        int from_port;
+        Endpoint from;
 
-        while (NetworkUtils::receiveMessage(sockfd, msg, from_ip, from_port)) {
+        while (NetworkUtils::receiveMessage(fd, msg, from)) {
             switch (msg.type) {
                 case STATUS_UPDATE:
                     handleStatusUpdate(msg);
                     break;
+                case STATUS_SNAPSHOT:
+                    handleSnapshot(msg);
+                    break;
+                case STATUS_DELTA:
+                    handleDelta(msg);
+                    break;
                 case SHUTDOWN:
                     handleShutdown(msg);
                     break;
@@ -200,21 +302,198 @@ class ObserverClient {
         }
     }
 
-    void handleShutdown(const Message& msg) {
-        std::cout << "\n🛑 Получена команда завершения от сервера: " << msg.data << std::endl;
-        running = false;
+    void handleSnapshot(const Message& msg) {
+        StatusFrame frame;
+        if (msg.client_id != client_id || !StatusStream::parseFrame(msg, frame)) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(model_mutex);
+
+            if (!snapshot_in_progress || frame.sequence != snapshot_sequence) {
+                snapshot_model.clear();
+                snapshot_sequence = frame.sequence;
+                snapshot_in_progress = true;
+            }
+
+            for (const auto& record : frame.records) {
+                snapshot_model[record.info.id] = record;
+            }
+            resync_requested = std::chrono::steady_clock::now();
+
+            if (snapshot_model.size() < frame.total) {
+                return;
+            }
+
+            model.swap(snapshot_model);
+            snapshot_model.clear();
+            last_sequence = frame.sequence;
+            snapshot_in_progress = false;
+            synced = applyPendingDeltas();
+        }
+
+        if (!synced) {
+            requestResync();
+            return;
+        }
+
+        render_pending = true;
+    }
+
+    bool applyPendingDeltas() {
+        uint32_t base = last_sequence;
+        std::stable_sort(pending_deltas.begin(),
+                         pending_deltas.end(),
+                         [base](const StatusFrame& a, const StatusFrame& b) {
+                             return static_cast<int32_t>(a.sequence - base) <
+                                    static_cast<int32_t>(b.sequence - base);
+                         });
+
+        bool complete = true;
+        for (const StatusFrame& frame : pending_deltas) {
+            if (static_cast<int32_t>(frame.sequence - last_sequence) <= 0) {
+                continue;
+            }
+            if (frame.sequence != last_sequence + 1) {
+                complete = false;
+                break;
+            }
+            applyDelta(frame);
+        }
+
+        pending_deltas.clear();
+        return complete;
+    }
+
+    void applyDelta(const StatusFrame& frame) {
+        for (const auto& record : frame.records) {
+            model[record.info.id] = record;
+        }
+        last_sequence = frame.sequence;
     }
 
-    void requestStatusUpdate() {
-        if (!registered)
+    void bufferDelta(const StatusFrame& frame) {
+        if (pending_deltas.size() == PENDING_DELTA_LIMIT) {
+            pending_deltas.pop_front();
+        }
+        pending_deltas.push_back(frame);
+    }
+
+    void handleDelta(const Message& msg) {
+        StatusFrame frame;
+        if (msg.client_id != client_id || !StatusStream::parseFrame(msg, frame)) {
             return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(model_mutex);
+
+            if (!synced) {
+                bufferDelta(frame);
+                return;
+            }
+
+            if (static_cast<int32_t>(frame.sequence - last_sequence) <= 0) {
+                return;
+            }
+
+            if (frame.sequence != last_sequence + 1) {
+                synced = false;
+                bufferDelta(frame);
+            } else {
+                applyDelta(frame);
+            }
+        }
+
+        if (!synced) {
+            requestResync();
+            return;
+        }
+
+        render_pending = true;
+    }
+
+    void checkResync() {
+        bool stale;
+        {
+            std::lock_guard<std::mutex> lock(model_mutex);
+            stale = !synced &&
+                    std::chrono::steady_clock::now() - resync_requested > std::chrono::seconds(1);
+        }
+
+        if (stale) {
+            requestResync();
+        }
+    }
+
+    void requestResync() {
+        if (!registered && multicast_fd < 0)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(model_mutex);
+            synced = false;
+            resync_requested = std::chrono::steady_clock::now();
+        }
 
         Message msg;
-        msg.type = STATUS_UPDATE;
+        msg.type = STATUS_RESYNC;
         msg.client_id = client_id;
-        strcpy(msg.data, "Request status update");
 
-        NetworkUtils::sendMessage(sockfd, msg, server_ip, server_port);
+        NetworkUtils::sendMessage(sockfd, msg, server);
+    }
+
+    void renderModel() {
+        std::string status = "=== СОСТОЯНИЕ СИСТЕМЫ ===\n";
+        status += "Время: " + NetworkUtils::getCurrentTime() + "\n\n";
+
+        {
+            std::lock_guard<std::mutex> lock(model_mutex);
+            for (const auto& pair : model) {
+                appendProgrammerStatus(status, pair.second);
+            }
+        }
+
+        clearScreen();
+        std::cout << status << std::endl;
+        std::cout << "Команды: (q)uit, (r)efresh, (h)elp, Enter - обновить" << std::endl;
+    }
+
+    void appendProgrammerStatus(std::string& status, const StatusRecord& record) {
+        const ProgrammerInfo& info = record.info;
+        status += "Программист: " + info.name + " (ID: " + std::to_string(info.id) + ")\n";
+        status += "  Состояние: ";
+
+        switch (info.state) {
+            case WRITING:
+                status += "Пишет программу";
+                break;
+            case WAITING_REVIEW:
+                status += "Ожидает проверки";
+                break;
+            case REVIEWING:
+                status += "Проверяет программу";
+                break;
+            case FIXING:
+                status += "Исправляет программу";
+                break;
+            case SLEEPING:
+                status += "Спит";
+                break;
+        }
+
+        status += "\n  Подключен: " + std::string(info.is_connected ? "Да" : "Нет") + "\n";
+        status += "  Текущая активность: " + info.current_activity + "\n";
+        status += "  Написано программ: " + std::to_string(info.programs_written) + "\n";
+        status += "  Проверено программ: " + std::to_string(info.programs_reviewed) + "\n";
+        status += "  Программ в очереди на проверку: " + std::to_string(record.queue_depth) +
+                  "\n\n";
+    }
+
+    void handleShutdown(const Message& msg) {
+        std::cout << "\n🛑 Получена команда завершения от сервера: " << msg.data << std::endl;
+        running = false;
     }
 
     void clearScreen() {
@@ -226,9 +505,9 @@ class ObserverClient {
         std::cout << "\n=== ПОМОЩЬ ===" << std::endl;
         std::cout << "Доступные команды:" << std::endl;
         std::cout << "  q - Выход из программы" << std::endl;
-        std::cout << "  r - Принудительное обновление статуса" << std::endl;
+        std::cout << "  r - Запросить полный снимок состояния у сервера" << std::endl;
         std::cout << "  h - Показать эту справку" << std::endl;
-        std::cout << "  Enter - Обновить статус" << std::endl;
+        std::cout << "  Enter - Перерисовать текущее состояние" << std::endl;
         std::cout << "\nСистема автоматически обновляет статус при изменениях." << std::endl;
         std::cout << "================\n" << std::endl;
     }
@@ -251,8 +530,10 @@ void restoreInput() {
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 4) {
-        std::cout << "Использование: " << argv[0] << " <SERVER_IP> <SERVER_PORT> <CLIENT_PORT>"
+    if (argc < 4) {
+        std::cout << "Использование: " << argv[0]
+                  << " <SERVER_IP> <SERVER_PORT> <CLIENT_PORT> [--multicast GROUP:PORT]"
+                     " [--multicast-if IP]"
                   << std::endl;
         std::cout << "Пример: " << argv[0] << " 127.0.0.1 8080 8090" << std::endl;
         return 1;
@@ -261,15 +542,42 @@ int main(int argc, char* argv[]) {
     std::string server_ip = argv[1];
     int server_port = std::atoi(argv[2]);
     int client_port = std::atoi(argv[3]);
+    std::string multicast_group;
+    int multicast_port = 0;
+    std::string multicast_interface;
 
     if (server_port <= 0 || server_port > 65535 || client_port <= 0 || client_port > 65535) {
         std::cout << "Ошибка: некорректный порт" << std::endl;
         return 1;
     }
 
+    if (!Endpoint(server_ip, server_port).valid()) {
+        std::cout << "Ошибка: некорректный адрес сервера" << std::endl;
+        return 1;
+    }
+
+    for (int i = 4; i < argc; i++) {
+        std::string option = argv[i];
+
+        if (option == "--multicast" && i + 1 < argc) {
+            if (!NetworkUtils::parseEndpoint(argv[++i], multicast_group, multicast_port)) {
+                std::cout << "Ошибка: некорректная multicast-группа" << std::endl;
+                return 1;
+            }
+        } else if (option == "--multicast-if" && i + 1 < argc) {
+            multicast_interface = argv[++i];
+        } else {
+            std::cout << "Ошибка: неизвестный параметр '" << option << "'" << std::endl;
+            return 1;
+        }
+    }
+
     setNonBlockingInput();
 
     ObserverClient client(server_ip, server_port, client_port);
+    if (!multicast_group.empty()) {
+        client.useMulticast(multicast_group, multicast_port, multicast_interface);
+    }
 
     bool result = client.start();
 
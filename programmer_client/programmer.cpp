@@ -1,34 +1,62 @@
+#include <poll.h>
 #include <signal.h>
 #include <unistd.h>
 
-#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <queue>
 #include <random>
-#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "../common/network_utils.h"
 #include "../common/protocol.h"
+#include "../common/reliable_channel.h"
+#include "programmer_agent.h"
 
-class ProgrammerClient {
+const int REGISTER_WINDOW = 64;
+const int REGISTER_RETRY_MS = 1000;
+const int REGISTER_TIMEOUT_MS = 10000;
+const int SWARM_REPORT_MS = 5000;
+const int CLIENT_BATCH_SIZE = 64;
+
+class ProgrammerClient : public AgentHost {
    private:
+    struct TimerEntry {
+        uint64_t at_ms;
+        size_t agent;
+        AgentTimer timer;
+        uint32_t generation;
+
+        bool operator>(const TimerEntry& other) const { return at_ms > other.at_ms; }
+    };
+
     int sockfd;
-    std::string server_ip;
-    int server_port;
+    Endpoint server;
     int client_port;
-    int client_id;
     std::string programmer_name;
+    int count;
     bool running;
-    bool registered;
+    bool reliable;
+
+    ReliableChannel channel;
 
-    ProgrammerState current_state;
-    int current_program_id;
-    int programs_written;
-    int programs_reviewed;
-    int review_target_id;
+    std::vector<ProgrammerAgent> agents;
+    std::unordered_map<int, size_t> agent_by_id;
+    std::unordered_map<std::string, size_t> agent_by_name;
+    size_t registered_count;
+
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<TimerEntry>> timers;
+    std::vector<uint32_t> timer_generation;
+
+    std::vector<Message> outbox;
+    std::vector<Endpoint> outbox_peers;
+    std::vector<Message> receive_batch;
+    std::vector<Endpoint> receive_sources;
 
     std::random_device rd;
     std::mt19937 gen;
+    int session;
 
     static ProgrammerClient* instance;
 
@@ -36,29 +64,37 @@ class ProgrammerClient {
     ProgrammerClient(const std::string& name,
                      const std::string& server_ip,
                      int server_port,
-                     int client_port)
-        : programmer_name(name),
-          server_ip(server_ip),
-          server_port(server_port),
+                     int client_port,
+                     int swarm_size = 1,
+                     bool reliable_delivery = false,
+                     uint32_t seed = 0)
+        : server(server_ip, server_port),
           client_port(client_port),
-          client_id(0),
+          programmer_name(name),
+          count(swarm_size),
           running(false),
-          registered(false),
-          current_state(WRITING),
-          current_program_id(0),
-          programs_written(0),
-          programs_reviewed(0),
-          review_target_id(0),
-          gen(rd()) {
+          reliable(reliable_delivery),
+          registered_count(0),
+          timer_generation(swarm_size * AGENT_TIMER_COUNT, 0),
+          receive_batch(CLIENT_BATCH_SIZE),
+          gen(seed != 0 ? seed : rd()),
+          session(static_cast<int>(rd() & 0x7fffffff) | 1) {
+        agents.reserve(count);
+        for (int i = 0; i < count; i++) {
+            std::string agent_name = count == 1 ? name : name + "_" + std::to_string(i + 1);
+            agents.push_back(ProgrammerAgent(i, agent_name, *this, count == 1));
+            agent_by_name[agent_name] = i;
+        }
+
         instance = this;
         signal(SIGINT, signalHandler);
         signal(SIGTERM, signalHandler);
     }
 
-    static void signalHandler(int signal) {
+    static void signalHandler(int) {
         if (instance) {
             std::cout << "\nПолучен сигнал завершения..." << std::endl;
-            instance->disconnect();
+            instance->running = false;
         }
     }
 
@@ -73,336 +109,285 @@ class ProgrammerClient {
             return false;
         }
 
-        std::cout << "Программист '" << programmer_name << "' запущен на порту " << client_port
-                  << std::endl;
-
-        if (!registerWithServer()) {
-            close(sockfd);
-            return false;
+        if (count == 1) {
+            std::cout << "Программист '" << programmer_name << "' запущен на порту "
+                      << client_port << std::endl;
+        } else {
+            std::cout << "Рой из " << count << " программистов '" << programmer_name
+                      << "' запущен на порту " << client_port << std::endl;
         }
 
         running = true;
+        bool ok = registerWithServer();
+        if (ok) {
+            eventLoop();
+        }
 
-        std::thread message_thread(&ProgrammerClient::messageLoop, this);
-        std::thread work_thread(&ProgrammerClient::workLoop, this);
-        std::thread heartbeat_thread(&ProgrammerClient::heartbeatLoop, this);
+        disconnect();
+        close(sockfd);
+        return ok;
+    }
 
-        message_thread.join();
-        work_thread.join();
-        heartbeat_thread.join();
+    void send(const Message& msg) {
+        Message stamped = msg;
+        if (reliable) {
+            channel.stamp(stamped, server, ReliableChannel::monotonicMs());
+        }
+        outbox.push_back(stamped);
+        outbox_peers.push_back(server);
+    }
 
-        return true;
+    void schedule(size_t agent, AgentTimer timer, uint64_t delay_ms) {
+        TimerEntry entry;
+        entry.at_ms = ReliableChannel::monotonicMs() + delay_ms;
+        entry.agent = agent;
+        entry.timer = timer;
+        entry.generation = ++timer_generation[agent * AGENT_TIMER_COUNT + timer];
+        timers.push(entry);
     }
 
+    std::mt19937& random() { return gen; }
+
+   private:
     void disconnect() {
-        if (!running)
+        if (registered_count == 0) {
             return;
+        }
 
+        if (count > 1) {
+            printSwarmSummary(agents);
+        }
         std::cout << "Отключаемся от сервера..." << std::endl;
 
-        if (registered) {
-            Message msg;
-            msg.type = DISCONNECT;
-            msg.client_id = client_id;
-            strcpy(msg.data, "Client disconnecting");
-
-            NetworkUtils::sendMessage(sockfd, msg, server_ip, server_port);
+        for (ProgrammerAgent& agent : agents) {
+            agent.disconnect();
         }
-
-        running = false;
-        close(sockfd);
+        flushOutbox();
     }
 
-   private:
     bool registerWithServer() {
-        Message msg;
-        msg.type = REGISTER_PROGRAMMER;
-        msg.client_id = 0;
-        strcpy(msg.data, programmer_name.c_str());
-
-        if (!NetworkUtils::sendMessage(sockfd, msg, server_ip, server_port)) {
-            std::cout << "Ошибка отправки регистрации на сервер" << std::endl;
-            return false;
-        }
+        uint64_t start_ms = ReliableChannel::monotonicMs();
+        uint64_t retry_ms = start_ms;
 
-        std::string from_ip;
-        int from_port;
-        auto start_time = std::chrono::steady_clock::now();
-
-        while (std::chrono::steady_clock::now() - start_time < std::chrono::seconds(10)) {
-            if (NetworkUtils::receiveMessage(sockfd, msg, from_ip, from_port)) {
-                if (msg.type == REGISTER_PROGRAMMER) {
-                    client_id = msg.client_id;
-                    registered = true;
-                    std::cout << "Зарегистрированы на сервере с ID: " << client_id << std::endl;
-                    return true;
-                }
+        while (running && registered_count < agents.size()) {
+            uint64_t now = ReliableChannel::monotonicMs();
+            if (now - start_ms >= static_cast<uint64_t>(REGISTER_TIMEOUT_MS)) {
+                break;
             }
-            usleep(100000);
-        }
 
-        std::cout << "Таймаут регистрации на сервере" << std::endl;
-        return false;
-    }
+            if (now >= retry_ms) {
+                sendRegistrations();
+                retry_ms = now + REGISTER_RETRY_MS;
+            }
 
-    void messageLoop() {
-        while (running) {
+            waitSocket(static_cast<int>(retry_ms - now));
             processMessages();
-            usleep(100000);
         }
-    }
 
-    void workLoop() {
-        while (running) {
-            performWork();
-            std::this_thread::sleep_for(std::chrono::seconds(2));
+        if (registered_count == 0) {
+            std::cout << "Таймаут регистрации на сервере" << std::endl;
+            return false;
         }
-    }
 
-    void heartbeatLoop() {
-        while (running && registered) {
-            sendHeartbeat();
-            std::this_thread::sleep_for(std::chrono::seconds(HEARTBEAT_INTERVAL));
+        if (registered_count < agents.size()) {
+            std::cout << "Зарегистрировано " << registered_count << " из " << agents.size()
+                      << " программистов" << std::endl;
+        } else if (count > 1) {
+            std::cout << "Зарегистрированы все " << count << " программистов" << std::endl;
         }
+        return true;
     }
 
-    void processMessages() {
-        Message msg;
-        std::string from_ip;
-        int from_port;
-
-        while (NetworkUtils::receiveMessage(sockfd, msg, from_ip, from_port)) {
-            switch (msg.type) {
-                case REVIEW_RESULT:
-                    handleReviewResult(msg);
-                    break;
-                case REQUEST_REVIEW:
-                    handleReviewAssignment(msg);
-                    break;
-                case ASSIGNMENT_NOTIFICATION:
-                    handleAssignmentNotification(msg);
-                    break;
-                case SHUTDOWN:
-                    handleShutdown(msg);
-                    break;
-                default:
-
-                    break;
+    void sendRegistrations() {
+        int in_flight = 0;
+        for (ProgrammerAgent& agent : agents) {
+            if (agent.id() != 0) {
+                continue;
             }
-        }
-    }
-
-    void handleReviewResult(const Message& msg) {
-        if (msg.target_id != client_id)
-            return;
-
-        current_program_id = msg.program_id;
 
-        if (msg.result == CORRECT) {
-            std::cout << "✓ Программа " << current_program_id << " принята! Пишу новую программу."
-                      << std::endl;
-            current_state = WRITING;
-            programs_written++;
-        } else {
-            std::cout << "✗ Программа " << current_program_id << " отклонена. Исправляю..."
-                      << std::endl;
-            current_state = FIXING;
-            review_target_id = msg.client_id;
+            Message request;
+            request.type = REGISTER_PROGRAMMER;
+            request.client_id = 0;
+            request.program_id = session;
+            snprintf(request.data, sizeof(request.data), "%s", agent.name().c_str());
+            send(request);
+
+            if (++in_flight % REGISTER_WINDOW == 0) {
+                flushOutbox();
+                waitSocket(10);
+                processMessages();
+            }
         }
+        flushOutbox();
     }
 
-    void handleReviewAssignment(const Message& msg) {
-        if (msg.client_id != client_id)
-            return;
+    void eventLoop() {
+        uint64_t report_at = ReliableChannel::monotonicMs() + SWARM_REPORT_MS;
 
-        if (msg.program_id == 0) {
-            if (current_state == WAITING_REVIEW) {
-                current_state = SLEEPING;
-                std::cout << "😴 Нет программ для проверки. Засыпаю..." << std::endl;
+        while (running) {
+            uint64_t now = ReliableChannel::monotonicMs();
+            int timeout = static_cast<int>(report_at > now ? report_at - now : 0);
+            if (!timers.empty()) {
+                uint64_t at = timers.top().at_ms;
+                timeout = std::min(timeout, static_cast<int>(at > now ? at - now : 0));
+            }
+            if (reliable) {
+                int retransmit = channel.nextTimeoutMs(now);
+                if (retransmit >= 0) {
+                    timeout = std::min(timeout, retransmit);
+                }
             }
-        } else {
-            std::cout << "📝 Получил программу '" << msg.data << "' (ID: " << msg.program_id
-                      << ") от программиста " << msg.target_id << " для проверки" << std::endl;
-
-            current_state = REVIEWING;
-
-            std::this_thread::sleep_for(std::chrono::seconds(3 + gen() % 5));
-
-            ReviewResult result = (gen() % 100 < 70) ? CORRECT : INCORRECT;
-
-            Message result_msg;
-            result_msg.type = REVIEW_RESULT;
-            result_msg.client_id = client_id;
-            result_msg.target_id = msg.target_id;
-            result_msg.program_id = msg.program_id;
-            result_msg.result = result;
-            strcpy(result_msg.data,
-                   (result == CORRECT) ? "Program is correct" : "Program has errors");
-
-            NetworkUtils::sendMessage(sockfd, result_msg, server_ip, server_port);
 
-            programs_reviewed++;
-            std::cout << "✅ Проверил программу " << msg.program_id
-                      << " - результат: " << (result == CORRECT ? "ПРАВИЛЬНО" : "НЕПРАВИЛЬНО")
-                      << std::endl;
+            waitSocket(timeout);
+            processMessages();
+            runTimers();
+            flushChannel();
+            flushOutbox();
 
-            current_state = WRITING;
+            if (count > 1 && ReliableChannel::monotonicMs() >= report_at) {
+                printSwarmSummary(agents);
+                report_at += SWARM_REPORT_MS;
+            }
         }
     }
 
-    void handleAssignmentNotification(const Message& msg) {
-        if (msg.client_id != client_id)
-            return;
-
-        std::cout << "🔔 Получено уведомление о новой программе для проверки: '" << msg.data
-                  << "' (ID: " << msg.program_id << ")" << std::endl;
+    void waitSocket(int timeout_ms) {
+        struct pollfd pfd;
+        pfd.fd = sockfd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        poll(&pfd, 1, timeout_ms);
     }
 
-    void handleShutdown(const Message& msg) {
-        std::cout << "🛑 Получена команда завершения от сервера: " << msg.data << std::endl;
-        running = false;
+    void processMessages() {
+        int received;
+        do {
+            received = NetworkUtils::receiveMessages(sockfd, receive_batch, receive_sources);
+            for (int i = 0; i < received; i++) {
+                if (acceptFromServer(receive_batch[i])) {
+                    dispatch(receive_batch[i]);
+                }
+            }
+        } while (received == CLIENT_BATCH_SIZE);
     }
 
-    void performWork() {
-        if (!registered || !running)
-            return;
-
-        switch (current_state) {
-            case WRITING:
-                writeProgram();
-                break;
-            case WAITING_REVIEW:
-                requestReview();
-                break;
-            case FIXING:
-                fixProgram();
-                break;
-            case SLEEPING:
-                requestReview();
-                break;
+    void dispatch(const Message& msg) {
+        switch (msg.type) {
+            case REGISTER_PROGRAMMER:
+                handleRegistered(msg);
+                return;
+            case SHUTDOWN:
+                handleShutdown(msg);
+                return;
             default:
                 break;
         }
-    }
 
-    void writeProgram() {
-        std::cout << "💻 Пишу программу..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::seconds(5 + gen() % 10));
-
-        current_program_id++;
-        std::string program_name =
-            "Программа_" + std::to_string(current_program_id) + "_от_" + programmer_name;
-
-        std::vector<int> available_reviewers;
-        for (int i = 1; i <= 10; i++) {
-            if (i != client_id) {
-                available_reviewers.push_back(i);
-            }
+        int id = msg.type == REVIEW_RESULT ? msg.target_id : msg.client_id;
+        auto it = agent_by_id.find(id);
+        if (it != agent_by_id.end()) {
+            agents[it->second].onMessage(msg);
         }
+    }
 
-        if (available_reviewers.empty()) {
-            std::cout << "❌ Нет доступных программистов для проверки" << std::endl;
+    void handleRegistered(const Message& msg) {
+        auto it = agent_by_name.find(msg.data);
+        if (it == agent_by_name.end() || agents[it->second].id() != 0) {
             return;
         }
 
-        int target_id = available_reviewers[gen() % available_reviewers.size()];
-
-        Message msg;
-        msg.type = SUBMIT_PROGRAM;
-        msg.client_id = client_id;
-        msg.target_id = target_id;
-        msg.program_id = current_program_id;
-        strcpy(msg.data, program_name.c_str());
+        ProgrammerAgent& agent = agents[it->second];
+        agent_by_id[msg.client_id] = it->second;
+        registered_count++;
 
-        if (NetworkUtils::sendMessage(sockfd, msg, server_ip, server_port)) {
-            std::cout << "📤 Отправил программу '" << program_name << "' на проверку программисту "
-                      << target_id << std::endl;
-            current_state = WAITING_REVIEW;
-        } else {
-            std::cout << "❌ Ошибка отправки программы на сервер" << std::endl;
+        if (count == 1) {
+            channel.setLocalId(msg.client_id);
+            std::cout << "Зарегистрированы на сервере с ID: " << msg.client_id << std::endl;
         }
+        agent.registered(msg.client_id);
     }
 
-    void fixProgram() {
-        std::cout << "🔧 Исправляю программу " << current_program_id << "..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::seconds(3 + gen() % 5));
+    void handleShutdown(const Message& msg) {
+        if (!running) {
+            return;
+        }
 
-        std::string program_name = "Исправленная_программа_" + std::to_string(current_program_id) +
-                                   "_от_" + programmer_name;
+        std::cout << "🛑 Получена команда завершения от сервера: " << msg.data << std::endl;
+        running = false;
+        registered_count = 0;
+    }
 
-        Message msg;
-        msg.type = SUBMIT_PROGRAM;
-        msg.client_id = client_id;
-        msg.target_id = review_target_id;
-        msg.program_id = current_program_id;
-        strcpy(msg.data, program_name.c_str());
+    void runTimers() {
+        uint64_t now = ReliableChannel::monotonicMs();
+        while (!timers.empty() && timers.top().at_ms <= now) {
+            TimerEntry entry = timers.top();
+            timers.pop();
 
-        if (NetworkUtils::sendMessage(sockfd, msg, server_ip, server_port)) {
-            std::cout << "📤 Отправил исправленную программу '" << program_name
-                      << "' на повторную проверку программисту " << review_target_id << std::endl;
-            current_state = WAITING_REVIEW;
-        } else {
-            std::cout << "❌ Ошибка отправки исправленной программы на сервер" << std::endl;
+            size_t slot = entry.agent * AGENT_TIMER_COUNT + entry.timer;
+            if (entry.generation == timer_generation[slot]) {
+                agents[entry.agent].onTimer(entry.timer);
+            }
         }
     }
 
-    void requestReview() {
-        Message msg;
-        msg.type = REQUEST_REVIEW;
-        msg.client_id = client_id;
-        strcpy(msg.data, "Requesting program to review");
-
-        NetworkUtils::sendMessage(sockfd, msg, server_ip, server_port);
+    bool acceptFromServer(const Message& msg) {
+        if (!reliable) {
+            return true;
+        }
+        return channel.accept(msg, server, ReliableChannel::monotonicMs());
     }
 
-    void sendHeartbeat() {
-        if (!registered)
+    void flushChannel() {
+        if (!reliable) {
             return;
+        }
 
-        Message msg;
-        msg.type = HEARTBEAT;
-        msg.client_id = client_id;
-        strcpy(msg.data, "alive");
-
-        NetworkUtils::sendMessage(sockfd, msg, server_ip, server_port);
+        std::vector<ReliableChannel::Outgoing> outgoing;
+        channel.poll(ReliableChannel::monotonicMs(), outgoing);
+        for (const auto& out : outgoing) {
+            outbox.push_back(out.msg);
+            outbox_peers.push_back(out.peer);
+        }
     }
 
-    void printStatus() {
-        std::cout << "\n=== СТАТУС ПРОГРАММИСТА '" << programmer_name << "' ===" << std::endl;
-        std::cout << "ID: " << client_id << std::endl;
-        std::cout << "Состояние: ";
-
-        switch (current_state) {
-            case WRITING:
-                std::cout << "Пишет программу";
-                break;
-            case WAITING_REVIEW:
-                std::cout << "Ожидает проверки";
-                break;
-            case REVIEWING:
-                std::cout << "Проверяет программу";
-                break;
-            case FIXING:
-                std::cout << "Исправляет программу";
-                break;
-            case SLEEPING:
-                std::cout << "Спит";
-                break;
+    void flushOutbox() {
+        if (outbox.empty()) {
+            return;
         }
 
-        std::cout << std::endl;
-        std::cout << "Программ написано: " << programs_written << std::endl;
-        std::cout << "Программ проверено: " << programs_reviewed << std::endl;
-        std::cout << "========================================\n" << std::endl;
+        NetworkUtils::sendMessages(sockfd, outbox, outbox_peers);
+        outbox.clear();
+        outbox_peers.clear();
     }
 };
 
 ProgrammerClient* ProgrammerClient::instance = nullptr;
 
 int main(int argc, char* argv[]) {
-    if (argc != 5) {
+    bool reliable = false;
+    int swarm_size = 1;
+    uint32_t seed = 0;
+    bool valid = argc >= 5;
+
+    for (int i = 5; i < argc && valid; i++) {
+        std::string arg = argv[i];
+        if (arg == "--reliable") {
+            reliable = true;
+        } else if (arg == "--swarm" && i + 1 < argc) {
+            swarm_size = std::atoi(argv[++i]);
+            valid = swarm_size > 0;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            valid = false;
+        }
+    }
+
+    if (!valid) {
         std::cout << "Использование: " << argv[0]
-                  << " <ИМЯ> <SERVER_IP> <SERVER_PORT> <CLIENT_PORT>" << std::endl;
+                  << " <ИМЯ> <SERVER_IP> <SERVER_PORT> <CLIENT_PORT> [--reliable] [--swarm N]"
+                     " [--seed S]"
+                  << std::endl;
         std::cout << "Пример: " << argv[0] << " Иван 127.0.0.1 8080 8081" << std::endl;
         return 1;
     }
@@ -417,7 +402,19 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    ProgrammerClient client(programmer_name, server_ip, server_port, client_port);
+    if (!Endpoint(server_ip, server_port).valid()) {
+        std::cout << "Ошибка: некорректный адрес сервера" << std::endl;
+        return 1;
+    }
+
+    if (reliable && swarm_size > 1) {
+        std::cout << "Ошибка: --reliable поддерживается только для одного программиста"
+                  << std::endl;
+        return 1;
+    }
+
+    ProgrammerClient client(
+        programmer_name, server_ip, server_port, client_port, swarm_size, reliable, seed);
 
     if (!client.start()) {
         std::cout << "Ошибка запуска клиента" << std::endl;
@@ -0,0 +1,340 @@
+#ifndef PROGRAMMER_AGENT_H
+#define PROGRAMMER_AGENT_H
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../common/protocol.h"
+
+enum AgentTimer { TIMER_WORK = 0, TIMER_REVIEW = 1, TIMER_HEARTBEAT = 2, AGENT_TIMER_COUNT = 3 };
+
+const int WORK_TICK_MS = 2000;
+
+class AgentHost {
+   public:
+    virtual ~AgentHost() {}
+
+    virtual void send(const Message& msg) = 0;
+    virtual void schedule(size_t agent, AgentTimer timer, uint64_t delay_ms) = 0;
+    virtual std::mt19937& random() = 0;
+};
+
+class ProgrammerAgent {
+   public:
+    ProgrammerAgent(size_t index, const std::string& name, AgentHost& host, bool verbose)
+        : index(index),
+          programmer_name(name),
+          host(host),
+          verbose(verbose),
+          client_id(0),
+          work_state(WRITING),
+          reviewing(false),
+          current_program_id(0),
+          programs_written(0),
+          programs_reviewed(0),
+          review_target_id(0),
+          reviews_received(0),
+          review_grant(0) {}
+
+    void registered(int id) {
+        client_id = id;
+        host.schedule(index, TIMER_HEARTBEAT, host.random()() % (HEARTBEAT_INTERVAL * 1000));
+        startWriting();
+    }
+
+    void onTimer(AgentTimer timer) {
+        switch (timer) {
+            case TIMER_WORK:
+                finishWork();
+                break;
+            case TIMER_REVIEW:
+                finishReview();
+                break;
+            case TIMER_HEARTBEAT:
+                sendHeartbeat();
+                host.schedule(index, TIMER_HEARTBEAT, HEARTBEAT_INTERVAL * 1000);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void onMessage(const Message& msg) {
+        switch (msg.type) {
+            case REVIEW_RESULT:
+                handleReviewResult(msg);
+                break;
+            case REQUEST_REVIEW:
+                handleReviewAssignment(msg);
+                break;
+            case ASSIGNMENT_NOTIFICATION:
+                handleAssignmentNotification(msg);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void disconnect() {
+        if (client_id == 0) {
+            return;
+        }
+
+        Message msg;
+        msg.type = DISCONNECT;
+        msg.client_id = client_id;
+        strcpy(msg.data, "Client disconnecting");
+
+        host.send(msg);
+    }
+
+    int id() const { return client_id; }
+    const std::string& name() const { return programmer_name; }
+    ProgrammerState state() const { return reviewing ? REVIEWING : work_state; }
+    int programsWritten() const { return programs_written; }
+    int programsReviewed() const { return programs_reviewed; }
+
+   private:
+    uint64_t randomDelayMs(int base_s, int spread_s) {
+        return static_cast<uint64_t>(base_s + host.random()() % spread_s) * 1000;
+    }
+
+    void startWriting() {
+        work_state = WRITING;
+        if (verbose) {
+            std::cout << "💻 Пишу программу..." << std::endl;
+        }
+        host.schedule(index, TIMER_WORK, randomDelayMs(5, 10));
+    }
+
+    void startFixing() {
+        work_state = FIXING;
+        if (verbose) {
+            std::cout << "🔧 Исправляю программу " << current_program_id << "..." << std::endl;
+        }
+        host.schedule(index, TIMER_WORK, randomDelayMs(3, 5));
+    }
+
+    void finishWork() {
+        switch (work_state) {
+            case WRITING:
+                writeProgram();
+                break;
+            case FIXING:
+                fixProgram();
+                break;
+            case WAITING_REVIEW:
+                work_state = SLEEPING;
+                if (verbose) {
+                    std::cout << "😴 Нет программ для проверки. Засыпаю..." << std::endl;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void writeProgram() {
+        current_program_id++;
+        std::string program_name =
+            "Программа_" + std::to_string(current_program_id) + "_от_" + programmer_name;
+
+        submit(ANY_REVIEWER, program_name);
+        if (verbose) {
+            std::cout << "📤 Отправил программу '" << program_name
+                      << "' на проверку (проверяющего выберет сервер)" << std::endl;
+        }
+    }
+
+    void fixProgram() {
+        std::string program_name = "Исправленная_программа_" + std::to_string(current_program_id) +
+                                   "_от_" + programmer_name;
+
+        submit(review_target_id, program_name);
+        if (verbose) {
+            std::cout << "📤 Отправил исправленную программу '" << program_name
+                      << "' на повторную проверку программисту " << review_target_id << std::endl;
+        }
+    }
+
+    void submit(int target_id, const std::string& program_name) {
+        Message msg;
+        msg.type = SUBMIT_PROGRAM;
+        msg.client_id = client_id;
+        msg.target_id = target_id;
+        msg.program_id = current_program_id;
+        snprintf(msg.data, sizeof(msg.data), "%s", program_name.c_str());
+
+        host.send(msg);
+
+        work_state = WAITING_REVIEW;
+        grantReviews(REVIEW_WINDOW);
+        host.schedule(index, TIMER_WORK, WORK_TICK_MS);
+    }
+
+    void handleReviewResult(const Message& msg) {
+        if (msg.target_id != client_id)
+            return;
+
+        current_program_id = msg.program_id;
+        grantReviews(0);
+
+        if (msg.result == CORRECT) {
+            if (verbose) {
+                std::cout << "✓ Программа " << current_program_id
+                          << " принята! Пишу новую программу." << std::endl;
+            }
+            programs_written++;
+            startWriting();
+        } else {
+            if (verbose) {
+                std::cout << "✗ Программа " << current_program_id << " отклонена. Исправляю..."
+                          << std::endl;
+            }
+            review_target_id = msg.client_id;
+            startFixing();
+        }
+    }
+
+    void handleReviewAssignment(const Message& msg) {
+        if (msg.client_id != client_id || msg.program_id == 0)
+            return;
+
+        if (msg.reviewer_id != 0) {
+            if (msg.reviewer_id != reviews_received + 1) {
+                sendCredit();
+                return;
+            }
+            reviews_received++;
+        }
+        pending_reviews.push_back(msg);
+        if (!reviewing) {
+            startReview();
+        }
+    }
+
+    void startReview() {
+        const Message& msg = pending_reviews.front();
+        if (verbose) {
+            std::cout << "📝 Получил программу '" << msg.data << "' (ID: " << msg.program_id
+                      << ") от программиста " << msg.target_id << " для проверки" << std::endl;
+        }
+
+        reviewing = true;
+        host.schedule(index, TIMER_REVIEW, randomDelayMs(3, 5));
+    }
+
+    void finishReview() {
+        if (!reviewing) {
+            return;
+        }
+
+        Message msg = pending_reviews.front();
+        pending_reviews.pop_front();
+
+        ReviewResult result = (host.random()() % 100 < 70) ? CORRECT : INCORRECT;
+
+        Message result_msg;
+        result_msg.type = REVIEW_RESULT;
+        result_msg.client_id = client_id;
+        result_msg.target_id = msg.target_id;
+        result_msg.program_id = msg.program_id;
+        result_msg.result = result;
+        strcpy(result_msg.data, (result == CORRECT) ? "Program is correct" : "Program has errors");
+
+        host.send(result_msg);
+
+        programs_reviewed++;
+        if (verbose) {
+            std::cout << "✅ Проверил программу " << msg.program_id
+                      << " - результат: " << (result == CORRECT ? "ПРАВИЛЬНО" : "НЕПРАВИЛЬНО")
+                      << std::endl;
+        }
+
+        reviewing = false;
+        if (!pending_reviews.empty()) {
+            startReview();
+        } else if (work_state == WAITING_REVIEW || work_state == SLEEPING) {
+            grantReviews(REVIEW_WINDOW);
+        }
+    }
+
+    void handleAssignmentNotification(const Message& msg) {
+        if (msg.client_id != client_id || !verbose)
+            return;
+
+        std::cout << "🔔 Получено уведомление о новой программе для проверки: '" << msg.data
+                  << "' (ID: " << msg.program_id << ")" << std::endl;
+    }
+
+    void grantReviews(int window) {
+        review_grant = reviews_received + window;
+        sendCredit();
+    }
+
+    void sendCredit() {
+        Message msg;
+        msg.type = REVIEW_CREDIT;
+        msg.client_id = client_id;
+        msg.program_id = review_grant;
+        msg.target_id = reviews_received;
+
+        host.send(msg);
+    }
+
+    void sendHeartbeat() {
+        Message msg;
+        msg.type = HEARTBEAT;
+        msg.client_id = client_id;
+        strcpy(msg.data, "alive");
+
+        host.send(msg);
+
+        if (review_grant != reviews_received) {
+            sendCredit();
+        }
+    }
+
+    size_t index;
+    std::string programmer_name;
+    AgentHost& host;
+    bool verbose;
+
+    int client_id;
+    ProgrammerState work_state;
+    bool reviewing;
+    int current_program_id;
+    int programs_written;
+    int programs_reviewed;
+    int review_target_id;
+    int reviews_received;
+    int review_grant;
+    std::deque<Message> pending_reviews;
+};
+
+inline void printSwarmSummary(const std::vector<ProgrammerAgent>& agents) {
+    int states[SLEEPING + 1] = {0};
+    long written = 0;
+    long reviewed = 0;
+
+    for (const ProgrammerAgent& agent : agents) {
+        if (agent.id() == 0) {
+            continue;
+        }
+        states[agent.state()]++;
+        written += agent.programsWritten();
+        reviewed += agent.programsReviewed();
+    }
+
+    std::cout << "📊 Рой: пишут " << states[WRITING] << ", ждут проверки "
+              << states[WAITING_REVIEW] + states[SLEEPING] << ", проверяют " << states[REVIEWING]
+              << ", исправляют " << states[FIXING] << "; принято программ " << written
+              << ", проверено " << reviewed << std::endl;
+}
+
+#endif
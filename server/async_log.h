@@ -0,0 +1,407 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../common/network_utils.h"
+#include "../common/protocol.h"
+#include "spsc_queue.h"
+
+enum LogLevel { LOG_DEBUG = 0, LOG_INFO = 1, LOG_WARN = 2, LOG_ERROR = 3, LOG_OFF = 4 };
+
+enum LogRecordKind { LOG_TEXT = 0, LOG_MESSAGE = 1 };
+
+struct LogRecordHeader {
+    uint64_t time_us;
+    uint8_t level;
+    uint8_t kind;
+    uint16_t length;
+    int32_t type;
+    int32_t client_id;
+    int32_t target_id;
+    int32_t program_id;
+    int32_t result;
+    uint32_t ack;
+};
+
+const size_t LOG_RECORD_SIZE = 256;
+const size_t LOG_TEXT_SIZE = LOG_RECORD_SIZE - sizeof(LogRecordHeader);
+
+struct LogRecord {
+    LogRecordHeader header;
+    char text[LOG_TEXT_SIZE];
+};
+
+class AsyncLog {
+   public:
+    static const size_t RING_CAPACITY = 4096;
+    static const int IDLE_SLEEP_MS = 2;
+    static const uint32_t BINARY_VERSION = 1;
+
+    static AsyncLog& instance() {
+        static AsyncLog log;
+        return log;
+    }
+
+    ~AsyncLog() {
+        stop();
+        closeSink();
+    }
+
+    static bool parseLevel(const std::string& value, LogLevel& level) {
+        const char* names[] = {"debug", "info", "warn", "error", "off"};
+        for (int i = LOG_DEBUG; i <= LOG_OFF; i++) {
+            if (value == names[i]) {
+                level = static_cast<LogLevel>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void setLevel(LogLevel level) { min_level.store(level, std::memory_order_relaxed); }
+
+    void setSampleEvery(uint32_t every) {
+        sample_every.store(every > 0 ? every : 1, std::memory_order_relaxed);
+    }
+
+    bool openText(const std::string& path) { return openSink(path, false); }
+
+    bool openBinary(const std::string& path) { return openSink(path, true); }
+
+    bool enabled(LogLevel level) const {
+        return level >= min_level.load(std::memory_order_relaxed);
+    }
+
+    void start() {
+        if (running.exchange(true)) {
+            return;
+        }
+        worker = std::thread(&AsyncLog::run, this);
+    }
+
+    void stop() {
+        if (!running.exchange(false)) {
+            return;
+        }
+        worker.join();
+    }
+
+    void message(LogLevel level, const Message& msg) {
+        if (!enabled(level)) {
+            return;
+        }
+
+        thread_local uint32_t seen = 0;
+        if (seen++ % sample_every.load(std::memory_order_relaxed) != 0) {
+            return;
+        }
+
+        LogRecord record = LogRecord();
+        record.header.level = static_cast<uint8_t>(level);
+        record.header.kind = LOG_MESSAGE;
+        record.header.type = msg.type;
+        record.header.client_id = msg.client_id;
+        record.header.target_id = msg.target_id;
+        record.header.program_id = msg.program_id;
+        record.header.result = msg.result;
+        record.header.ack = msg.ack;
+        record.header.length = 0;
+
+        if (!hasBinaryPayload(msg.type)) {
+            size_t len = strnlen(msg.data, LOG_TEXT_SIZE);
+            memcpy(record.text, msg.data, len);
+            record.header.length = static_cast<uint16_t>(len);
+        }
+
+        write(record);
+    }
+
+    void write(LogRecord& record) {
+        record.header.time_us = realtimeUs();
+
+        if (!running.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(sink_mutex);
+            emit(record);
+            fflush(sink);
+            return;
+        }
+
+        Ring& ring = localRing();
+        if (!ring.queue.push(record)) {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static std::string format(const LogRecord& record) {
+        time_t seconds = static_cast<time_t>(record.header.time_us / 1000000);
+        struct tm local;
+        localtime_r(&seconds, &local);
+
+        char stamp[64];
+        strftime(stamp, sizeof(stamp), "%a %b %e %H:%M:%S %Y", &local);
+
+        std::ostringstream out;
+        out << "[" << stamp << "] ";
+
+        if (record.header.kind == LOG_MESSAGE) {
+            Message msg;
+            msg.type = static_cast<MessageType>(record.header.type);
+            msg.client_id = record.header.client_id;
+            msg.target_id = record.header.target_id;
+            msg.program_id = record.header.program_id;
+            msg.result = static_cast<ReviewResult>(record.header.result);
+            msg.ack = record.header.ack;
+            memcpy(msg.data, record.text, record.header.length);
+            msg.data[record.header.length] = '\0';
+
+            out << "Получено: ";
+            NetworkUtils::describeMessage(out, msg);
+        } else {
+            out.write(record.text, record.header.length);
+        }
+
+        return out.str();
+    }
+
+    static bool writeBinaryHeader(FILE* file) {
+        uint32_t header[3] = {BINARY_MAGIC, BINARY_VERSION, sizeof(LogRecordHeader)};
+        return fwrite(header, sizeof(header), 1, file) == 1;
+    }
+
+    static bool readBinaryHeader(FILE* file) {
+        uint32_t header[3];
+        return fread(header, sizeof(header), 1, file) == 1 && header[0] == BINARY_MAGIC &&
+               header[1] == BINARY_VERSION && header[2] == sizeof(LogRecordHeader);
+    }
+
+    static bool readBinaryRecord(FILE* file, LogRecord& record) {
+        if (fread(&record.header, sizeof(record.header), 1, file) != 1 ||
+            record.header.length > LOG_TEXT_SIZE) {
+            return false;
+        }
+        return fread(record.text, 1, record.header.length, file) == record.header.length;
+    }
+
+   private:
+    static const uint32_t BINARY_MAGIC = 0x474f4c55;
+
+    struct Ring {
+        SpscQueue<LogRecord> queue;
+        std::atomic<size_t> dropped;
+
+        Ring() : queue(RING_CAPACITY), dropped(0) {}
+    };
+
+    AsyncLog()
+        : min_level(LOG_DEBUG), sample_every(1), running(false), sink(stdout), binary(false) {}
+
+    static uint64_t realtimeUs() {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    bool openSink(const std::string& path, bool binary_format) {
+        FILE* file = fopen(path.c_str(), binary_format ? "wb" : "w");
+        if (!file || (binary_format && !writeBinaryHeader(file))) {
+            if (file) {
+                fclose(file);
+            }
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(sink_mutex);
+        closeSink();
+        sink = file;
+        binary = binary_format;
+        return true;
+    }
+
+    void closeSink() {
+        if (sink != stdout) {
+            fclose(sink);
+            sink = stdout;
+        } else {
+            fflush(sink);
+        }
+    }
+
+    Ring& localRing() {
+        thread_local Ring* ring = nullptr;
+        if (!ring) {
+            std::lock_guard<std::mutex> lock(rings_mutex);
+            rings.push_back(std::unique_ptr<Ring>(new Ring()));
+            ring = rings.back().get();
+        }
+        return *ring;
+    }
+
+    void emit(const LogRecord& record) {
+        if (binary) {
+            fwrite(&record.header, sizeof(record.header), 1, sink);
+            fwrite(record.text, 1, record.header.length, sink);
+            return;
+        }
+
+        std::string line = format(record);
+        line.push_back('\n');
+        fwrite(line.data(), 1, line.size(), sink);
+    }
+
+    void reportDropped(size_t count) {
+        LogRecord record = LogRecord();
+        record.header.time_us = realtimeUs();
+        record.header.level = LOG_WARN;
+        record.header.kind = LOG_TEXT;
+        int len = snprintf(record.text, LOG_TEXT_SIZE, "Журнал: пропущено записей: %zu", count);
+        record.header.length = static_cast<uint16_t>(len);
+        emit(record);
+    }
+
+    size_t drain() {
+        std::vector<Ring*> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex);
+            for (const auto& ring : rings) {
+                snapshot.push_back(ring.get());
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(sink_mutex);
+        size_t drained = 0;
+        LogRecord record = LogRecord();
+
+        for (Ring* ring : snapshot) {
+            while (ring->queue.pop(record)) {
+                emit(record);
+                drained++;
+            }
+
+            size_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped > 0) {
+                reportDropped(dropped);
+            }
+        }
+
+        return drained;
+    }
+
+    void run() {
+        sigset_t signals;
+        sigfillset(&signals);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        while (true) {
+            bool stopping = !running.load(std::memory_order_acquire);
+            if (drain() > 0) {
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(sink_mutex);
+                fflush(sink);
+            }
+
+            if (stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+        }
+    }
+
+    std::atomic<int> min_level;
+    std::atomic<uint32_t> sample_every;
+    std::atomic<bool> running;
+    std::thread worker;
+
+    std::mutex rings_mutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    std::mutex sink_mutex;
+    FILE* sink;
+    bool binary;
+};
+
+class LogLine {
+   public:
+    explicit LogLine(LogLevel level) : active(AsyncLog::instance().enabled(level)) {
+        if (active) {
+            memset(&record, 0, sizeof(record));
+            record.header.level = static_cast<uint8_t>(level);
+            record.header.kind = LOG_TEXT;
+        }
+    }
+
+    ~LogLine() {
+        if (active) {
+            AsyncLog::instance().write(record);
+        }
+    }
+
+    LogLine& operator<<(const char* text) {
+        if (active) {
+            append(text, strlen(text));
+        }
+        return *this;
+    }
+
+    LogLine& operator<<(const std::string& text) {
+        if (active) {
+            append(text.data(), text.size());
+        }
+        return *this;
+    }
+
+    LogLine& operator<<(int value) { return appendNumber("%d", value); }
+    LogLine& operator<<(unsigned value) { return appendNumber("%u", value); }
+    LogLine& operator<<(long value) { return appendNumber("%ld", value); }
+    LogLine& operator<<(unsigned long value) { return appendNumber("%lu", value); }
+    LogLine& operator<<(long long value) { return appendNumber("%lld", value); }
+    LogLine& operator<<(unsigned long long value) { return appendNumber("%llu", value); }
+    LogLine& operator<<(double value) { return appendNumber("%g", value); }
+
+   private:
+    template <typename T>
+    LogLine& appendNumber(const char* format, T value) {
+        if (active) {
+            char buffer[32];
+            int len = snprintf(buffer, sizeof(buffer), format, value);
+            append(buffer, static_cast<size_t>(len));
+        }
+        return *this;
+    }
+
+    void append(const char* text, size_t len) {
+        size_t room = LOG_TEXT_SIZE - record.header.length;
+        if (len > room) {
+            len = room;
+        }
+        memcpy(record.text + record.header.length, text, len);
+        record.header.length = static_cast<uint16_t>(record.header.length + len);
+    }
+
+    bool active;
+    LogRecord record;
+};
+
+#define LOG_LINE(level)                             \
+    if (!AsyncLog::instance().enabled(level)) {     \
+    } else                                          \
+        LogLine(level)
+
+#endif
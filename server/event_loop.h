@@ -0,0 +1,168 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <map>
+
+class EventLoop {
+   public:
+    typedef std::function<void(uint32_t)> Handler;
+
+    EventLoop() : epoll_fd(-1), running(false), dispatching_fd(-1) {}
+
+    ~EventLoop() {
+        if (epoll_fd >= 0) {
+            close(epoll_fd);
+        }
+    }
+
+    bool init() {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            perror("epoll_create1 failed");
+            return false;
+        }
+        return true;
+    }
+
+    bool add(int fd, uint32_t events, const Handler& handler) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = events;
+        ev.data.fd = fd;
+
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            perror("epoll_ctl failed");
+            return false;
+        }
+
+        handlers[fd] = handler;
+        return true;
+    }
+
+    void remove(int fd) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        auto it = handlers.find(fd);
+        if (it == handlers.end()) {
+            return;
+        }
+        if (fd == dispatching_fd) {
+            retired.swap(it->second);
+        }
+        handlers.erase(it);
+    }
+
+    void run() {
+        running = true;
+        while (running) {
+            runOnce(-1);
+        }
+    }
+
+    void runOnce(int timeout_ms) {
+        struct epoll_event events[MAX_EVENTS];
+        int n = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout_ms);
+
+        if (n < 0) {
+            if (errno != EINTR) {
+                perror("epoll_wait failed");
+                running = false;
+            }
+            return;
+        }
+
+        for (int i = 0; i < n; i++) {
+            auto it = handlers.find(events[i].data.fd);
+            if (it != handlers.end()) {
+                dispatching_fd = it->first;
+                const Handler& handler = it->second;
+                handler(events[i].events);
+                dispatching_fd = -1;
+            }
+        }
+        retired = Handler();
+    }
+
+    void stop() { running = false; }
+
+    static int createTimerFd(int interval_ms) {
+        int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (fd < 0) {
+            perror("timerfd_create failed");
+            return -1;
+        }
+
+        struct itimerspec spec;
+        memset(&spec, 0, sizeof(spec));
+        spec.it_interval.tv_sec = interval_ms / 1000;
+        spec.it_interval.tv_nsec = (interval_ms % 1000) * 1000000L;
+        spec.it_value = spec.it_interval;
+
+        if (timerfd_settime(fd, 0, &spec, nullptr) < 0) {
+            perror("timerfd_settime failed");
+            close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    static uint64_t readTimerFd(int fd) {
+        uint64_t expirations = 0;
+        if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+            return 0;
+        }
+        return expirations;
+    }
+
+    static int createSignalFd(std::initializer_list<int> signals) {
+        sigset_t mask;
+        sigemptyset(&mask);
+        for (int sig : signals) {
+            sigaddset(&mask, sig);
+        }
+
+        if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0) {
+            perror("pthread_sigmask failed");
+            return -1;
+        }
+
+        int fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (fd < 0) {
+            perror("signalfd failed");
+            return -1;
+        }
+
+        return fd;
+    }
+
+    static int readSignalFd(int fd) {
+        struct signalfd_siginfo info;
+        if (read(fd, &info, sizeof(info)) != sizeof(info)) {
+            return 0;
+        }
+        return static_cast<int>(info.ssi_signo);
+    }
+
+   private:
+    static const int MAX_EVENTS = 64;
+
+    int epoll_fd;
+    bool running;
+    int dispatching_fd;
+    std::map<int, Handler> handlers;
+    Handler retired;
+};
+
+#endif
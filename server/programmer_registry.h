@@ -0,0 +1,202 @@
+#ifndef PROGRAMMER_REGISTRY_H
+#define PROGRAMMER_REGISTRY_H
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../common/endpoint.h"
+#include "../common/protocol.h"
+#include "review_pool.h"
+#include "string_interner.h"
+#include "timer_wheel.h"
+
+enum ActivityKind {
+    ACTIVITY_STARTING = 0,
+    ACTIVITY_WRITING = 1,
+    ACTIVITY_WAITING_REVIEW = 2,
+    ACTIVITY_REVIEWING = 3,
+    ACTIVITY_FIXING = 4
+};
+
+class ProgrammerRegistry {
+   public:
+    typedef Endpoint Address;
+
+    explicit ProgrammerRegistry(int first_id = 1, int stride = 1)
+        : first_id(first_id), stride(stride) {}
+
+    int add(const std::string& programmer_name,
+            const Address& programmer_address,
+            const std::string& requested_name,
+            int client_session = 0) {
+        int id = idAt(size());
+        registrations[std::make_pair(programmer_address, requested_name)] = size();
+
+        state.push_back(WRITING);
+        programs_written.push_back(0);
+        programs_reviewed.push_back(0);
+        current_program_id.push_back(0);
+        last_activity.push_back(0);
+        connected.push_back(1);
+        address.push_back(programmer_address);
+        heartbeat_timer.push_back(TimerWheel::TimerId(TimerWheel::INVALID_TIMER));
+        review_queue.push_back(ReviewQueue());
+        review_granted.push_back(0);
+        review_sent.push_back(0);
+        review_pushed.push_back(ReviewQueue());
+        review_acked.push_back(0);
+        review_pushed_at.push_back(0);
+        session.push_back(client_session);
+        activity.push_back(ACTIVITY_STARTING);
+        activity_program.push_back(0);
+        activity_name.push_back(StringInterner::Handle(StringInterner::NONE));
+
+        name.push_back(strings.acquire(programmer_name.c_str()));
+
+        return id;
+    }
+
+    bool find(int id, size_t& slot) const {
+        if (id < first_id || (id - first_id) % stride != 0) {
+            return false;
+        }
+
+        slot = static_cast<size_t>((id - first_id) / stride);
+        return slot < size();
+    }
+
+    bool findRegistration(const std::string& requested_name,
+                          const Address& programmer_address,
+                          size_t& slot) const {
+        auto it = registrations.find(std::make_pair(programmer_address, requested_name));
+        if (it == registrations.end()) {
+            return false;
+        }
+        slot = it->second;
+        return true;
+    }
+
+    bool contains(int id) const {
+        size_t slot;
+        return find(id, slot);
+    }
+
+    int idAt(size_t slot) const { return first_id + static_cast<int>(slot) * stride; }
+
+    size_t size() const { return state.size(); }
+
+    const char* nameOf(size_t slot) const { return strings.get(name[slot]); }
+
+    void setActivity(size_t slot,
+                     ActivityKind kind,
+                     int program_id = 0,
+                     StringInterner::Handle program_name = StringInterner::NONE) {
+        strings.retain(program_name);
+        strings.release(activity_name[slot]);
+
+        activity[slot] = kind;
+        activity_program[slot] = program_id;
+        activity_name[slot] = program_name;
+    }
+
+    void setActivity(size_t slot, ActivityKind kind, int program_id, const char* program_name) {
+        StringInterner::Handle handle = strings.acquire(program_name);
+        setActivity(slot, kind, program_id, handle);
+        strings.release(handle);
+    }
+
+    std::string activityText(size_t slot) const {
+        const char* program_name = strings.get(activity_name[slot]);
+
+        switch (activity[slot]) {
+            case ACTIVITY_WRITING:
+                return "Пишет новую программу";
+            case ACTIVITY_WAITING_REVIEW:
+                return std::string("Ожидает проверки программы ") + program_name;
+            case ACTIVITY_REVIEWING:
+                return std::string("Проверяет программу '") + program_name + "'";
+            case ACTIVITY_FIXING:
+                return "Исправляет программу (ID: " + std::to_string(activity_program[slot]) + ")";
+            default:
+                return "Starting work";
+        }
+    }
+
+    ReviewRecord& pushReview(size_t slot, int program_id, int author_id, const char* program_name) {
+        return reviews.push(review_queue[slot], program_id, author_id, idAt(slot),
+                            strings.acquire(program_name));
+    }
+
+    const ReviewRecord& frontReview(size_t slot) const { return reviews.front(review_queue[slot]); }
+
+    void popReview(size_t slot) {
+        strings.release(reviews.front(review_queue[slot]).program_name);
+        reviews.pop(review_queue[slot]);
+    }
+
+    void markPushed(size_t slot, uint64_t now_ms) {
+        reviews.moveFront(review_queue[slot], review_pushed[slot]);
+        review_pushed_at[slot] = now_ms;
+    }
+
+    void popPushed(size_t slot) {
+        strings.release(reviews.front(review_pushed[slot]).program_name);
+        reviews.pop(review_pushed[slot]);
+    }
+
+    void restartSession(size_t slot, int client_session) {
+        session[slot] = client_session;
+        reviews.prependAll(review_pushed[slot], review_queue[slot]);
+        review_granted[slot] = 0;
+        review_sent[slot] = 0;
+        review_acked[slot] = 0;
+        state[slot] = WRITING;
+        current_program_id[slot] = 0;
+        setActivity(slot, ACTIVITY_STARTING);
+    }
+
+    void fill(size_t slot, ProgrammerInfo& info) const {
+        info.id = idAt(slot);
+        info.name = nameOf(slot);
+        info.state = state[slot];
+        info.programs_written = programs_written[slot];
+        info.programs_reviewed = programs_reviewed[slot];
+        info.current_program_id = current_program_id[slot];
+        info.current_activity = activityText(slot);
+        info.last_activity = last_activity[slot];
+        info.is_connected = connected[slot] != 0;
+    }
+
+    std::vector<ProgrammerState> state;
+    std::vector<int> programs_written;
+    std::vector<int> programs_reviewed;
+    std::vector<int> current_program_id;
+    std::vector<time_t> last_activity;
+    std::vector<unsigned char> connected;
+    std::vector<Address> address;
+    std::vector<TimerWheel::TimerId> heartbeat_timer;
+    std::vector<ReviewQueue> review_queue;
+    std::vector<uint32_t> review_granted;
+    std::vector<uint32_t> review_sent;
+    std::vector<ReviewQueue> review_pushed;
+    std::vector<uint32_t> review_acked;
+    std::vector<uint64_t> review_pushed_at;
+    std::vector<int> session;
+    std::vector<ActivityKind> activity;
+    std::vector<int> activity_program;
+    std::vector<StringInterner::Handle> activity_name;
+
+    std::vector<StringInterner::Handle> name;
+    StringInterner strings;
+    ReviewPool reviews;
+
+   private:
+    std::map<std::pair<Address, std::string>, size_t> registrations;
+    int first_id;
+    int stride;
+};
+
+#endif
@@ -0,0 +1,1365 @@
+#ifndef PROGRAMMERS_SERVER_H
+#define PROGRAMMERS_SERVER_H
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../common/network_utils.h"
+#include "../common/protocol.h"
+#include "../common/reliable_channel.h"
+#include "../common/status_stream.h"
+#include "../common/transport.h"
+#include "../common/uring_transport.h"
+#include "async_log.h"
+#include "event_loop.h"
+#include "programmer_registry.h"
+#include "reviewer_picker.h"
+#include "send_pacer.h"
+#include "server_clock.h"
+#include "shard_router.h"
+#include "timer_wheel.h"
+#include "traffic_journal.h"
+
+enum LoopMode { LOOP_POLL = 1, LOOP_EPOLL = 2 };
+
+enum TransportMode { TRANSPORT_SOCKET = 1, TRANSPORT_URING = 2 };
+
+const int STATUS_INTERVAL_MS = 50;
+
+struct ServerOptions {
+    LoopMode loop_mode;
+    TransportMode transport_mode;
+    std::string multicast_group;
+    int multicast_port;
+    std::string multicast_interface;
+    int status_interval_ms;
+    AssignPolicy assign_policy;
+    uint32_t random_seed;
+    TrafficJournal* journal;
+    ServerClock* clock;
+
+    ServerOptions()
+        : loop_mode(LOOP_EPOLL),
+          transport_mode(TRANSPORT_SOCKET),
+          multicast_port(0),
+          status_interval_ms(STATUS_INTERVAL_MS),
+          assign_policy(ASSIGN_TWO_CHOICES),
+          random_seed(0),
+          journal(nullptr),
+          clock(nullptr) {}
+};
+
+const int TIMER_TICK_MS = 100;
+const int RECEIVE_BATCH_SIZE = 32;
+const double STATUS_SEND_RATE = 2000.0;
+const double STATUS_SEND_BURST = 32.0;
+const size_t STATUS_QUEUE_LIMIT = 4096;
+const size_t LEGACY_STATUS_LIMIT = 1000;
+
+class ProgrammersServer {
+   private:
+    int sockfd;
+    std::string server_ip;
+    int server_port;
+    bool running;
+    ServerOptions options;
+    ServerClock system_clock;
+    ServerClock* clock;
+    std::unique_ptr<Transport> transport;
+
+    ProgrammerRegistry programmers;
+    ReviewerPicker reviewers;
+    std::map<int, Endpoint> observer_addresses;
+    Endpoint multicast_endpoint;
+    std::set<int> stream_observers;
+    std::vector<int> dirty_programmers;
+    uint64_t status_flush_at;
+    uint32_t status_sequence;
+
+    uint64_t status_generation;
+    uint64_t text_cache_generation;
+    uint64_t snapshot_cache_generation;
+    uint32_t snapshot_cache_sequence;
+    std::string status_text;
+    std::vector<Message> status_chunks;
+    std::vector<Message> snapshot_frames;
+    ProgrammerInfo status_scratch;
+    SendPacer status_pacer;
+
+    int next_observer_id;
+    int next_program_id;
+    int id_stride;
+
+    ShardRouter* router;
+    int shard_index;
+    std::vector<std::deque<ShardEnvelope>> shard_outbox;
+    std::map<int, std::pair<ProgrammerInfo, size_t>> replicas;
+
+    TimerWheel timers;
+    ReliableChannel reliability;
+    std::vector<ReliableChannel::Outgoing> reliable_out;
+
+    std::vector<Message> receive_batch;
+    std::vector<Endpoint> receive_sources;
+    char display_id[24];
+
+    std::random_device rd;
+    std::mt19937 gen;
+
+    static volatile sig_atomic_t& stopSignal() {
+        static volatile sig_atomic_t stop = 0;
+        return stop;
+    }
+
+   public:
+    ProgrammersServer(const std::string& ip,
+                      int port,
+                      const ServerOptions& server_options = ServerOptions())
+        : server_ip(ip),
+          server_port(port),
+          running(false),
+          options(server_options),
+          clock(options.clock ? options.clock : &system_clock),
+          status_flush_at(0),
+          status_sequence(0),
+          status_generation(1),
+          text_cache_generation(0),
+          snapshot_cache_generation(0),
+          snapshot_cache_sequence(0),
+          status_pacer(STATUS_SEND_RATE, STATUS_SEND_BURST, STATUS_QUEUE_LIMIT),
+          next_observer_id(FIRST_OBSERVER_ID),
+          next_program_id(1),
+          id_stride(1),
+          router(nullptr),
+          shard_index(0),
+          timers(TIMER_TICK_MS, clock->monotonicMs()),
+          receive_batch(RECEIVE_BATCH_SIZE),
+          receive_sources(RECEIVE_BATCH_SIZE),
+          gen(server_options.random_seed != 0 ? server_options.random_seed : rd()) {
+        reviewers = ReviewerPicker(options.assign_policy, gen());
+        signal(SIGINT, signalHandler);
+        signal(SIGTERM, signalHandler);
+    }
+
+    static void signalHandler(int) { stopSignal() = 1; }
+
+    void attachShard(ShardRouter* shard_router, int index) {
+        router = shard_router;
+        shard_index = index;
+        options.loop_mode = LOOP_EPOLL;
+        id_stride = router->count();
+        programmers = ProgrammerRegistry(index + 1, id_stride);
+        if (options.random_seed != 0) {
+            gen.seed(options.random_seed + index);
+        }
+        reviewers = ReviewerPicker(options.assign_policy, gen());
+        next_program_id = index + 1;
+        shard_outbox.resize(router->count());
+    }
+
+    void attachTransport(std::unique_ptr<Transport> custom) { transport = std::move(custom); }
+
+    void pump() {
+        processMessages();
+        flushPending();
+    }
+
+    void advanceTimers() { timers.advance(clock->monotonicMs()); }
+
+    bool start() {
+        sockfd = NetworkUtils::createUDPSocket();
+        if (sockfd < 0) {
+            return false;
+        }
+
+        if (router && !NetworkUtils::enableReusePort(sockfd)) {
+            close(sockfd);
+            return false;
+        }
+
+        if (!NetworkUtils::bindSocket(sockfd, server_ip, server_port)) {
+            close(sockfd);
+            return false;
+        }
+
+        if (multicastEnabled() && !options.multicast_interface.empty() &&
+            !NetworkUtils::setMulticastInterface(sockfd, options.multicast_interface)) {
+            close(sockfd);
+            return false;
+        }
+
+        if (multicastEnabled()) {
+            multicast_endpoint.assign(options.multicast_group, options.multicast_port);
+        }
+
+        if (!createTransport()) {
+            close(sockfd);
+            return false;
+        }
+
+        if (router) {
+            LOG_LINE(LOG_INFO) << "Шард " << shard_index << " запущен на " << server_ip << ":"
+                              << server_port;
+        } else {
+            LOG_LINE(LOG_INFO) << "Сервер запущен на " << server_ip << ":" << server_port;
+            LOG_LINE(LOG_INFO) << "Для завершения работы нажмите Ctrl+C";
+        }
+
+        running = true;
+
+        if (options.loop_mode == LOOP_EPOLL) {
+            return eventLoop();
+        }
+
+        mainLoop();
+
+        return true;
+    }
+
+    void shutdown() {
+        if (!running)
+            return;
+
+        LOG_LINE(LOG_INFO) << "Отправляем команду завершения всем клиентам...";
+
+        Message shutdown_msg;
+        shutdown_msg.type = SHUTDOWN;
+        shutdown_msg.client_id = 0;
+        strcpy(shutdown_msg.data, "Server is shutting down");
+
+        std::vector<Endpoint> addrs;
+        addrs.insert(addrs.end(), programmers.address.begin(), programmers.address.end());
+        for (const auto& pair : observer_addresses) {
+            addrs.push_back(pair.second);
+        }
+        if (multicastEnabled() && (!router || shard_index == 0)) {
+            addrs.push_back(multicast_endpoint);
+        }
+
+        transport->sendMessages(std::vector<Message>(addrs.size(), shutdown_msg), addrs);
+        transport->flush();
+
+        sleep(2);
+
+        if (reliability.retransmittedCount() > 0 || reliability.expiredCount() > 0) {
+            LOG_LINE(LOG_INFO) << "Надёжная доставка: повторных отправок "
+                              << reliability.retransmittedCount() << ", дубликатов "
+                              << reliability.duplicateCount() << ", потеряно "
+                              << reliability.expiredCount();
+        }
+
+        running = false;
+        close(sockfd);
+        LOG_LINE(LOG_INFO) << "Сервер остановлен.";
+    }
+
+   private:
+    bool createTransport() {
+        if (options.transport_mode == TRANSPORT_URING) {
+            std::unique_ptr<UringTransport> uring(new UringTransport(sockfd));
+            if (!uring->init()) {
+                LOG_LINE(LOG_ERROR) << "Ошибка инициализации io_uring";
+                return false;
+            }
+            transport.reset(uring.release());
+        } else {
+            transport.reset(new SocketTransport(sockfd));
+        }
+        transport->setTap(options.journal);
+        return true;
+    }
+
+    void mainLoop() {
+        while (running) {
+            if (stopSignal()) {
+                LOG_LINE(LOG_INFO) << "Получен сигнал завершения. Останавливаем сервер...";
+                shutdown();
+                break;
+            }
+
+            processMessages();
+            timers.advance(clock->monotonicMs());
+            flushPending();
+            usleep(100000);
+        }
+    }
+
+    bool eventLoop() {
+        EventLoop loop;
+        if (!loop.init()) {
+            close(sockfd);
+            return false;
+        }
+
+        int timer_fd = EventLoop::createTimerFd(TIMER_TICK_MS);
+        int signal_fd = router ? -1 : EventLoop::createSignalFd({SIGINT, SIGTERM});
+        if (timer_fd < 0 || (!router && signal_fd < 0)) {
+            close(sockfd);
+            return false;
+        }
+
+        int transport_fd = transport->pollFd();
+        loop.add(transport_fd, EPOLLIN, [this](uint32_t) { processMessages(); });
+
+        loop.add(timer_fd, EPOLLIN, [this, timer_fd](uint32_t) {
+            EventLoop::readTimerFd(timer_fd);
+            timers.advance(clock->monotonicMs());
+        });
+
+        if (router) {
+            loop.add(router->wakeFd(shard_index), EPOLLIN, [this, transport_fd, &loop](uint32_t) {
+                router->clearWake(shard_index);
+                if (!processShardMessages()) {
+                    loop.remove(transport_fd);
+                    shutdown();
+                    loop.stop();
+                }
+            });
+        } else {
+            loop.add(signal_fd, EPOLLIN, [this, signal_fd, transport_fd, &loop](uint32_t) {
+                if (EventLoop::readSignalFd(signal_fd) != 0) {
+                    LOG_LINE(LOG_INFO) << "Получен сигнал завершения. Останавливаем сервер...";
+                    loop.remove(transport_fd);
+                    shutdown();
+                    loop.stop();
+                }
+            });
+        }
+
+        while (running) {
+            loop.runOnce(loopTimeoutMs());
+            flushPending();
+        }
+
+        close(timer_fd);
+        if (signal_fd >= 0) {
+            close(signal_fd);
+        }
+        return true;
+    }
+
+    void flushPending() {
+        uint64_t now = clock->monotonicMs();
+        flushStatusUpdates(now);
+        flushShardOutbox();
+        flushReliability(now);
+        status_pacer.drain(*transport, now);
+        transport->flush();
+    }
+
+    int loopTimeoutMs() const {
+        uint64_t now = clock->monotonicMs();
+        int timeout = status_pacer.nextDelayMs(now);
+        int deadlines[] = {reliability.nextTimeoutMs(now), statusFlushDelayMs(now)};
+        for (int deadline : deadlines) {
+            if (deadline >= 0 && (timeout < 0 || deadline < timeout)) {
+                timeout = deadline;
+            }
+        }
+        if (hasPendingShardMessages() && (timeout < 0 || timeout > 1)) {
+            timeout = 1;
+        }
+        return timeout;
+    }
+
+    void processMessages() {
+        int count;
+
+        do {
+            count = transport->receiveMessages(receive_batch, receive_sources);
+            if (options.journal) {
+                options.journal->endBatch();
+            }
+
+            for (int i = 0; i < count; i++) {
+                handleMessage(receive_batch[i], receive_sources[i]);
+            }
+        } while (count == RECEIVE_BATCH_SIZE);
+    }
+
+    void handleMessage(const Message& msg, const Endpoint& from) {
+        if (router) {
+            int owner = ownerShard(msg);
+            if (owner != shard_index) {
+                ShardEnvelope envelope(SHARD_DELIVER, msg);
+                envelope.peer = from;
+                envelope.format = transport->peerFormat(from);
+                sendToShard(owner, envelope);
+                return;
+            }
+        }
+
+        dispatchMessage(msg, from);
+    }
+
+    void dispatchMessage(const Message& msg, const Endpoint& from) {
+        if (!reliability.accept(msg, from, clock->monotonicMs())) {
+            return;
+        }
+
+        AsyncLog::instance().message(LOG_DEBUG, msg);
+
+        switch (msg.type) {
+            case REGISTER_PROGRAMMER:
+                handleRegisterProgrammer(msg, from);
+                break;
+            case REGISTER_OBSERVER:
+                handleRegisterObserver(msg, from);
+                break;
+            case SUBMIT_PROGRAM:
+                handleSubmitProgram(msg, from);
+                break;
+            case REQUEST_REVIEW:
+                handleRequestReview(msg, from);
+                break;
+            case REVIEW_RESULT:
+                handleReviewResult(msg, from);
+                break;
+            case REVIEW_CREDIT:
+                handleReviewCredit(msg, from);
+                break;
+            case DISCONNECT:
+                handleDisconnect(msg, from);
+                break;
+            case HEARTBEAT:
+                handleHeartbeat(msg, from);
+                break;
+            case STATUS_UPDATE:
+            case STATUS_RESYNC:
+                handleStatusRequest(msg, from);
+                break;
+            default:
+                LOG_LINE(LOG_WARN) << "Неизвестный тип сообщения: " << msg.type;
+        }
+    }
+
+    void handleRegisterProgrammer(const Message& msg, const Endpoint& from) {
+        std::string name = std::string(msg.data);
+        if (name.empty()) {
+            name = "Программист" + std::to_string(programmers.idAt(programmers.size()));
+        }
+
+        size_t slot;
+        int id = 0;
+        bool retry = programmers.findRegistration(msg.data, from, slot);
+
+        if (retry && isNewSession(msg, slot)) {
+            id = programmers.idAt(slot);
+            programmers.restartSession(slot, msg.program_id);
+            loadChanged(slot);
+            programmerChanged(id);
+            LOG_LINE(LOG_INFO) << "Программист " << name << " (ID: " << id
+                              << ") перезапущен с адреса " << from.toString();
+        }
+
+        if (retry) {
+            id = programmers.idAt(slot);
+            if (!programmers.connected[slot]) {
+                setConnected(slot, true);
+                dispatchReviews(slot);
+                programmerChanged(id);
+            }
+            touchProgrammer(slot);
+        } else {
+            id = programmers.add(name, from, msg.data, msg.program_id);
+            reviewers.add(programmers.size() - 1);
+            touchProgrammer(programmers.size() - 1);
+        }
+
+        if (msg.ack != 0) {
+            reliability.forget(from);
+            reliability.bind(from, id);
+        }
+
+        Message response;
+        response.type = REGISTER_PROGRAMMER;
+        response.client_id = id;
+        strcpy(response.data, name.c_str());
+
+        sendToClient(response, from);
+
+        if (retry) {
+            return;
+        }
+
+        LOG_LINE(LOG_INFO) << "Зарегистрирован программист " << name << " (ID: " << id
+                          << ") с адреса " << from.toString();
+
+        programmerChanged(id);
+    }
+
+    bool isNewSession(const Message& msg, size_t slot) const {
+        if (msg.program_id == 0) {
+            return !programmers.connected[slot];
+        }
+        return msg.program_id != programmers.session[slot];
+    }
+
+    void handleRegisterObserver(const Message& msg, const Endpoint& from) {
+        int id = next_observer_id--;
+        observer_addresses[id] = from;
+        if (msg.target_id >= STATUS_STREAM_VERSION) {
+            stream_observers.insert(id);
+        }
+
+        Message response;
+        response.type = REGISTER_OBSERVER;
+        response.client_id = id;
+        strcpy(response.data, "Observer registered");
+
+        transport->sendMessage(response, from);
+
+        LOG_LINE(LOG_INFO) << "Зарегистрирован наблюдатель (ID: " << id << ") с адреса "
+                          << from.toString();
+
+        sendFullStatusToObserver(id);
+    }
+
+    void handleSubmitProgram(const Message& msg, const Endpoint&) {
+        int author_id = msg.client_id;
+        int target_id = msg.target_id;
+
+        if (!programmers.contains(author_id)) {
+            LOG_LINE(LOG_WARN) << "Ошибка: неизвестный программист";
+            return;
+        }
+
+        if (target_id != ANY_REVIEWER && !isLocal(target_id)) {
+            sendToShard(router->shardOf(target_id), ShardEnvelope(SHARD_SUBMIT, msg));
+            return;
+        }
+
+        if (forwardToNextShard(msg)) {
+            return;
+        }
+
+        int reviewer_id;
+        StringInterner::Handle program_name;
+        int program_id = enqueueReview(msg, reviewer_id, program_name);
+        if (program_id == 0) {
+            return;
+        }
+
+        applySubmitted(author_id, reviewer_id, program_id, program_name);
+    }
+
+    bool forwardToNextShard(const Message& msg) {
+        if (msg.target_id != ANY_REVIEWER || !router || router->count() == 1 ||
+            reviewers.candidates(localSlot(msg.client_id)) != 0) {
+            return false;
+        }
+
+        int next = (shard_index + 1) % router->count();
+        if (next == router->shardOf(msg.client_id)) {
+            return false;
+        }
+
+        sendToShard(next, ShardEnvelope(SHARD_SUBMIT, msg));
+        return true;
+    }
+
+    int enqueueReview(const Message& msg, int& reviewer_id, StringInterner::Handle& name_handle) {
+        int author_id = msg.client_id;
+
+        size_t target;
+        if (!programmers.find(msg.target_id, target) || !programmers.connected[target]) {
+            target = reviewers.pick(localSlot(author_id),
+                                    [this](size_t slot) { return reviewLoad(slot); });
+        }
+        if (target == ReviewerPicker::NONE) {
+            LOG_LINE(LOG_WARN) << "Ошибка: нет доступных программистов для проверки";
+            return 0;
+        }
+
+        int target_id = programmers.idAt(target);
+        reviewer_id = target_id;
+
+        int program_id = next_program_id;
+        next_program_id += id_stride;
+        char program_name[sizeof(Message::data)];
+        programName(msg.data, program_id, program_name, sizeof(program_name));
+        ReviewRecord& review = programmers.pushReview(target, program_id, author_id, program_name);
+        review.submitted_time = clock->wallTime();
+        name_handle = review.program_name;
+        loadChanged(target);
+
+        if (dispatchReviews(target) == 0) {
+            Message notification;
+            notification.type = ASSIGNMENT_NOTIFICATION;
+            notification.client_id = target_id;
+            notification.program_id = program_id;
+            notification.target_id = author_id;
+            strcpy(notification.data, program_name);
+
+            sendToClient(notification, programmers.address[target]);
+        }
+
+        programmerChanged(target_id);
+        return program_id;
+    }
+
+    void applySubmitted(int author_id,
+                        int target_id,
+                        int program_id,
+                        StringInterner::Handle program_name) {
+        size_t author;
+        if (!programmers.find(author_id, author)) {
+            return;
+        }
+
+        programmers.state[author] = WAITING_REVIEW;
+        loadChanged(author);
+        programmers.current_program_id[author] = program_id;
+        programmers.setActivity(author, ACTIVITY_WAITING_REVIEW, program_id, program_name);
+        touchProgrammer(author);
+
+        LOG_LINE(LOG_INFO) << "Программист " << programmers.nameOf(author) << " отправил программу '"
+                          << programmers.strings.get(program_name) << "' на проверку программисту "
+                          << displayName(target_id);
+
+        programmerChanged(author_id);
+    }
+
+    void handleRequestReview(const Message& msg, const Endpoint& from) {
+        int reviewer_id = msg.client_id;
+
+        size_t reviewer;
+        if (!programmers.find(reviewer_id, reviewer)) {
+            return;
+        }
+
+        if (programmers.review_queue[reviewer].empty()) {
+            Message response;
+            response.type = REQUEST_REVIEW;
+            response.client_id = reviewer_id;
+            response.program_id = 0;
+            strcpy(response.data, "No programs to review");
+
+            sendToClient(response, from);
+            return;
+        }
+
+        startReview(reviewer, from);
+    }
+
+    void handleReviewCredit(const Message& msg, const Endpoint& from) {
+        size_t reviewer;
+        if (!programmers.find(msg.client_id, reviewer) || programmers.address[reviewer] != from) {
+            return;
+        }
+
+        acknowledgeReviews(reviewer, static_cast<uint32_t>(msg.target_id));
+        programmers.review_granted[reviewer] = static_cast<uint32_t>(msg.program_id);
+        resendReviews(reviewer);
+        dispatchReviews(reviewer);
+    }
+
+    void acknowledgeReviews(size_t reviewer, uint32_t received) {
+        uint32_t& acked = programmers.review_acked[reviewer];
+        if (static_cast<int32_t>(received - acked) <= 0 ||
+            static_cast<int32_t>(programmers.review_sent[reviewer] - received) < 0) {
+            return;
+        }
+
+        while (acked != received) {
+            programmers.popPushed(reviewer);
+            acked++;
+        }
+    }
+
+    void resendReviews(size_t reviewer) {
+        uint64_t now = clock->monotonicMs();
+        uint64_t pushed_at = programmers.review_pushed_at[reviewer];
+        if (programmers.review_pushed[reviewer].empty() ||
+            now - pushed_at < static_cast<uint64_t>(REVIEW_RESEND_MS)) {
+            return;
+        }
+
+        programmers.review_pushed_at[reviewer] = now;
+        uint32_t number = programmers.review_acked[reviewer];
+        const Endpoint& to = programmers.address[reviewer];
+        programmers.reviews.forEach(programmers.review_pushed[reviewer],
+                                    [&](const ReviewRecord& review) {
+                                        sendReview(reviewer, review, ++number, to);
+                                    });
+
+        LOG_LINE(LOG_DEBUG) << "Повторно отправлено проверок программисту "
+                           << programmers.nameOf(reviewer) << ": "
+                           << programmers.review_pushed[reviewer].size();
+    }
+
+    size_t dispatchReviews(size_t reviewer) {
+        size_t dispatched = 0;
+        while (programmers.connected[reviewer] &&
+               static_cast<int32_t>(programmers.review_granted[reviewer] -
+                                    programmers.review_sent[reviewer]) > 0 &&
+               !programmers.review_queue[reviewer].empty()) {
+            uint32_t push = ++programmers.review_sent[reviewer];
+            startReview(reviewer, programmers.address[reviewer], push);
+            dispatched++;
+        }
+        return dispatched;
+    }
+
+    size_t reviewLoad(size_t slot) const {
+        return programmers.review_queue[slot].size() + (programmers.state[slot] == REVIEWING);
+    }
+
+    void loadChanged(size_t slot) { reviewers.update(slot, reviewLoad(slot)); }
+
+    void sendReview(size_t reviewer,
+                    const ReviewRecord& review,
+                    uint32_t push,
+                    const Endpoint& to) {
+        Message response;
+        response.type = REQUEST_REVIEW;
+        response.client_id = programmers.idAt(reviewer);
+        response.program_id = review.program_id;
+        response.target_id = review.author_id;
+        response.reviewer_id = static_cast<int>(push);
+        strcpy(response.data, programmers.strings.get(review.program_name));
+
+        sendToClient(response, to);
+    }
+
+    void startReview(size_t reviewer, const Endpoint& to, uint32_t push = 0) {
+        int reviewer_id = programmers.idAt(reviewer);
+        const ReviewRecord& review = programmers.frontReview(reviewer);
+        const char* program_name = programmers.strings.get(review.program_name);
+
+        sendReview(reviewer, review, push, to);
+
+        programmers.state[reviewer] = REVIEWING;
+        programmers.setActivity(
+            reviewer, ACTIVITY_REVIEWING, review.program_id, review.program_name);
+        touchProgrammer(reviewer);
+
+        LOG_LINE(LOG_INFO) << "Программист " << programmers.nameOf(reviewer)
+                          << " начал проверку программы '" << program_name << "' от "
+                          << displayName(review.author_id);
+
+        if (push != 0) {
+            programmers.markPushed(reviewer, clock->monotonicMs());
+        } else {
+            programmers.popReview(reviewer);
+        }
+        loadChanged(reviewer);
+        programmerChanged(reviewer_id);
+    }
+
+    void handleReviewResult(const Message& msg, const Endpoint&) {
+        int reviewer_id = msg.client_id;
+        int author_id = msg.target_id;
+        int program_id = msg.program_id;
+        ReviewResult result = msg.result;
+
+        size_t reviewer;
+        if (!programmers.find(reviewer_id, reviewer) ||
+            (isLocal(author_id) && !programmers.contains(author_id))) {
+            return;
+        }
+
+        programmers.programs_reviewed[reviewer]++;
+        programmers.state[reviewer] = WRITING;
+        loadChanged(reviewer);
+        programmers.setActivity(reviewer, ACTIVITY_WRITING);
+        touchProgrammer(reviewer);
+
+        const char* result_str = (result == CORRECT) ? "ПРАВИЛЬНО" : "НЕПРАВИЛЬНО";
+        LOG_LINE(LOG_INFO) << "Программист " << programmers.nameOf(reviewer)
+                          << " проверил программу (ID: " << program_id << ") - результат: "
+                          << result_str;
+
+        programmerChanged(reviewer_id);
+
+        if (!isLocal(author_id)) {
+            sendToShard(router->shardOf(author_id), ShardEnvelope(SHARD_REVIEW_RESULT, msg));
+            return;
+        }
+
+        applyReviewToAuthor(msg);
+    }
+
+    void applyReviewToAuthor(const Message& msg) {
+        int author_id = msg.target_id;
+        int program_id = msg.program_id;
+
+        size_t author;
+        if (!programmers.find(author_id, author)) {
+            return;
+        }
+
+        sendToClient(msg, programmers.address[author]);
+
+        if (msg.result == CORRECT) {
+            programmers.programs_written[author]++;
+            programmers.state[author] = WRITING;
+            programmers.setActivity(author, ACTIVITY_WRITING);
+        } else {
+            programmers.state[author] = FIXING;
+            programmers.setActivity(author, ACTIVITY_FIXING, program_id);
+        }
+        loadChanged(author);
+        touchProgrammer(author);
+
+        programmerChanged(author_id);
+    }
+
+    void handleDisconnect(const Message& msg, const Endpoint& from) {
+        int client_id = msg.client_id;
+
+        size_t slot;
+        if (programmers.find(client_id, slot)) {
+            setConnected(slot, false);
+            timers.cancel(programmers.heartbeat_timer[slot]);
+            LOG_LINE(LOG_INFO) << "Программист " << programmers.nameOf(slot) << " (ID: " << client_id
+                              << ") отключился";
+            programmerChanged(client_id);
+        } else if (observer_addresses.find(client_id) != observer_addresses.end()) {
+            observer_addresses.erase(client_id);
+            stream_observers.erase(client_id);
+            LOG_LINE(LOG_INFO) << "Наблюдатель (ID: " << client_id << ") отключился";
+        } else if (router && shard_index != 0) {
+            ShardEnvelope envelope(SHARD_DELIVER, msg);
+            envelope.peer = from;
+            envelope.format = transport->peerFormat(from);
+            sendToShard(0, envelope);
+        }
+    }
+
+    void handleHeartbeat(const Message& msg, const Endpoint&) {
+        int client_id = msg.client_id;
+
+        size_t slot;
+        if (programmers.find(client_id, slot)) {
+            bool was_connected = programmers.connected[slot] != 0;
+            setConnected(slot, true);
+            touchProgrammer(slot);
+            if (!was_connected) {
+                dispatchReviews(slot);
+                programmerChanged(client_id);
+            }
+        }
+    }
+
+    void touchProgrammer(size_t slot) {
+        programmers.last_activity[slot] = clock->wallTime();
+        if (programmers.connected[slot]) {
+            armHeartbeatTimer(programmers.idAt(slot));
+        }
+    }
+
+    void armHeartbeatTimer(int id) {
+        size_t slot;
+        if (!programmers.find(id, slot)) {
+            return;
+        }
+
+        TimerWheel::TimerId& timer = programmers.heartbeat_timer[slot];
+        if (!timers.reschedule(timer, CLIENT_TIMEOUT * 1000)) {
+            timer = timers.schedule(CLIENT_TIMEOUT * 1000,
+                                    [this, id]() { handleHeartbeatTimeout(id); });
+        }
+    }
+
+    void handleHeartbeatTimeout(int id) {
+        size_t slot;
+        if (!programmers.find(id, slot) || !programmers.connected[slot]) {
+            return;
+        }
+
+        setConnected(slot, false);
+        LOG_LINE(LOG_INFO) << "Программист " << programmers.nameOf(slot) << " (ID: " << id
+                          << ") отключился по таймауту";
+        programmerChanged(id);
+    }
+
+    void setConnected(size_t slot, bool connected) {
+        programmers.connected[slot] = connected ? 1 : 0;
+        if (connected) {
+            reviewers.add(slot);
+        } else {
+            reviewers.remove(slot);
+        }
+    }
+
+    size_t localSlot(int programmer_id) const {
+        size_t slot;
+        return programmers.find(programmer_id, slot) ? slot : ReviewerPicker::NONE;
+    }
+
+    void sendToClient(const Message& msg, const Endpoint& to) {
+        if (!reliability.knows(to) && msg.ack == 0) {
+            transport->sendMessage(msg, to);
+            return;
+        }
+
+        Message stamped = msg;
+        if (reliability.knows(to)) {
+            reliability.stamp(stamped, to, clock->monotonicMs());
+        } else {
+            stamped.seq = 0;
+            stamped.ack = 0;
+            stamped.ack_mask = 0;
+        }
+        transport->sendMessage(stamped, to);
+    }
+
+    void flushReliability(uint64_t now) {
+        reliable_out.clear();
+        reliability.poll(now, reliable_out);
+        for (const auto& out : reliable_out) {
+            transport->sendMessage(out.msg, out.peer);
+        }
+    }
+
+    void programName(const char* requested, int program_id, char* name, size_t size) const {
+        if (requested[0] == '\0') {
+            snprintf(name, size, "Программа%d", program_id);
+        } else {
+            snprintf(name, size, "%s", requested);
+        }
+    }
+
+    const char* displayName(int id) {
+        size_t slot;
+        if (programmers.find(id, slot)) {
+            return programmers.nameOf(slot);
+        }
+        snprintf(display_id, sizeof(display_id), "ID %d", id);
+        return display_id;
+    }
+
+    bool isLocal(int programmer_id) const {
+        return !router || router->shardOf(programmer_id) == shard_index;
+    }
+
+    int ownerShard(const Message& msg) const {
+        switch (msg.type) {
+            case REGISTER_PROGRAMMER:
+                return shard_index;
+            case REGISTER_OBSERVER:
+            case STATUS_UPDATE:
+            case STATUS_RESYNC:
+                return 0;
+            default:
+                return router->shardOf(msg.client_id);
+        }
+    }
+
+    void sendToShard(int shard, const ShardEnvelope& envelope) {
+        shard_outbox[shard].push_back(envelope);
+    }
+
+    bool hasPendingShardMessages() const {
+        for (const auto& outbox : shard_outbox) {
+            if (!outbox.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void flushShardOutbox() {
+        for (size_t shard = 0; shard < shard_outbox.size(); shard++) {
+            auto& outbox = shard_outbox[shard];
+            bool pushed = false;
+
+            while (!outbox.empty() && router->push(shard_index, shard, outbox.front())) {
+                outbox.pop_front();
+                pushed = true;
+            }
+
+            if (pushed) {
+                router->wake(shard);
+            }
+        }
+    }
+
+    bool processShardMessages() {
+        ShardEnvelope envelope;
+
+        while (router->pop(shard_index, envelope)) {
+            switch (envelope.command) {
+                case SHARD_DELIVER:
+                    transport->notePeerFormat(envelope.peer, envelope.format);
+                    dispatchMessage(envelope.msg, envelope.peer);
+                    break;
+                case SHARD_SUBMIT: {
+                    if (forwardToNextShard(envelope.msg)) {
+                        break;
+                    }
+
+                    int reviewer_id;
+                    StringInterner::Handle program_name;
+                    int program_id = enqueueReview(envelope.msg, reviewer_id, program_name);
+                    if (program_id != 0) {
+                        ShardEnvelope accepted(SHARD_SUBMIT_ACCEPTED, envelope.msg);
+                        accepted.msg.program_id = program_id;
+                        accepted.msg.target_id = reviewer_id;
+                        sendToShard(router->shardOf(envelope.msg.client_id), accepted);
+                    }
+                    break;
+                }
+                case SHARD_SUBMIT_ACCEPTED: {
+                    char program_name[sizeof(Message::data)];
+                    programName(envelope.msg.data,
+                                envelope.msg.program_id,
+                                program_name,
+                                sizeof(program_name));
+                    StringInterner::Handle name = programmers.strings.acquire(program_name);
+                    applySubmitted(envelope.msg.client_id,
+                                   envelope.msg.target_id,
+                                   envelope.msg.program_id,
+                                   name);
+                    programmers.strings.release(name);
+                    break;
+                }
+                case SHARD_REVIEW_RESULT:
+                    applyReviewToAuthor(envelope.msg);
+                    break;
+                case SHARD_REPLICA:
+                    replicas[envelope.info.id] =
+                        std::make_pair(envelope.info, envelope.queue_depth);
+                    markStatusDirty(envelope.info.id);
+                    break;
+                case SHARD_STOP:
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    void programmerChanged(int id) { markStatusDirty(id); }
+
+    void markStatusDirty(int id) {
+        status_generation++;
+        if (observer_addresses.empty() && !multicastEnabled() && (!router || shard_index == 0)) {
+            return;
+        }
+        dirty_programmers.push_back(id);
+
+        if (status_flush_at == 0) {
+            status_flush_at = clock->monotonicMs() + options.status_interval_ms;
+        }
+    }
+
+    int statusFlushDelayMs(uint64_t now) const {
+        if (status_flush_at == 0) {
+            return -1;
+        }
+        return status_flush_at > now ? static_cast<int>(status_flush_at - now) : 0;
+    }
+
+    void flushStatusUpdates(uint64_t now) {
+        if (statusFlushDelayMs(now) != 0) {
+            return;
+        }
+        status_flush_at = 0;
+
+        std::sort(dirty_programmers.begin(), dirty_programmers.end());
+        dirty_programmers.erase(std::unique(dirty_programmers.begin(), dirty_programmers.end()),
+                                dirty_programmers.end());
+
+        if (router && shard_index != 0) {
+            sendReplicas();
+            return;
+        }
+
+        broadcastStatusUpdate();
+    }
+
+    void sendReplicas() {
+        for (int id : dirty_programmers) {
+            size_t slot;
+            if (!programmers.find(id, slot)) {
+                continue;
+            }
+
+            ShardEnvelope envelope;
+            envelope.command = SHARD_REPLICA;
+            programmers.fill(slot, envelope.info);
+            envelope.queue_depth = programmers.review_queue[slot].size();
+            sendToShard(0, envelope);
+        }
+        dirty_programmers.clear();
+    }
+
+    void broadcastStatusUpdate() {
+        std::vector<int> observer_ids;
+        for (const auto& pair : observer_addresses) {
+            if (stream_observers.find(pair.first) == stream_observers.end()) {
+                observer_ids.push_back(pair.first);
+            }
+        }
+
+        if (programmers.size() + replicas.size() <= LEGACY_STATUS_LIMIT) {
+            sendStatus(observer_ids);
+        } else {
+            sendStatusChanges(observer_ids);
+        }
+        sendStatusDeltas();
+    }
+
+    void handleStatusRequest(const Message& msg, const Endpoint& from) {
+        if (observer_addresses.find(msg.client_id) != observer_addresses.end()) {
+            sendFullStatusToObserver(msg.client_id);
+        } else if (msg.type == STATUS_RESYNC && multicastEnabled()) {
+            sendSnapshot(0, from);
+        }
+    }
+
+    bool multicastEnabled() const { return !options.multicast_group.empty(); }
+
+    void sendFullStatusToObserver(int observer_id) {
+        if (observer_addresses.find(observer_id) == observer_addresses.end()) {
+            return;
+        }
+
+        if (stream_observers.find(observer_id) != stream_observers.end()) {
+            sendSnapshot(observer_id, observer_addresses[observer_id]);
+            return;
+        }
+
+        sendStatus(std::vector<int>(1, observer_id));
+    }
+
+    template <typename Visitor>
+    void forEachProgrammerStatus(Visitor visit) {
+        size_t local = 0;
+        auto remote = replicas.begin();
+
+        while (local < programmers.size() || remote != replicas.end()) {
+            if (remote == replicas.end() ||
+                (local < programmers.size() && programmers.idAt(local) < remote->first)) {
+                programmers.fill(local, status_scratch);
+                visit(status_scratch, programmers.review_queue[local].size());
+                ++local;
+            } else {
+                visit(remote->second.first, remote->second.second);
+                ++remote;
+            }
+        }
+    }
+
+    bool findProgrammerStatus(int id, const ProgrammerInfo*& info, size_t& queued) {
+        size_t slot;
+        if (programmers.find(id, slot)) {
+            programmers.fill(slot, status_scratch);
+            info = &status_scratch;
+            queued = programmers.review_queue[slot].size();
+            return true;
+        }
+
+        auto remote = replicas.find(id);
+        if (remote != replicas.end()) {
+            info = &remote->second.first;
+            queued = remote->second.second;
+            return true;
+        }
+
+        return false;
+    }
+
+    const std::vector<Message>& statusChunks() {
+        if (text_cache_generation == status_generation) {
+            return status_chunks;
+        }
+
+        status_text.clear();
+        status_text += "=== СОСТОЯНИЕ СИСТЕМЫ ===\n";
+        status_text += "Время: " + NetworkUtils::getCurrentTime() + "\n\n";
+
+        forEachProgrammerStatus([this](const ProgrammerInfo& info, size_t queued) {
+            appendProgrammerStatus(status_text, info, queued);
+        });
+
+        splitStatusText(status_text, status_chunks);
+        text_cache_generation = status_generation;
+        return status_chunks;
+    }
+
+    void splitStatusText(const std::string& text, std::vector<Message>& chunks) const {
+        chunks.clear();
+        size_t chunk_capacity = sizeof(Message().data) - 1;
+        int part = 1;
+
+        for (size_t pos = 0; pos < text.length(); pos += chunk_capacity) {
+            chunks.push_back(Message());
+            Message& chunk = chunks.back();
+            chunk.type = STATUS_UPDATE;
+            chunk.program_id = part++;
+            text.copy(chunk.data, chunk_capacity, pos);
+        }
+
+        chunks.push_back(Message());
+        chunks.back().type = STATUS_UPDATE;
+        strcpy(chunks.back().data, "END_OF_STATUS");
+    }
+
+    void sendStatusChanges(const std::vector<int>& observer_ids) {
+        if (observer_ids.empty()) {
+            return;
+        }
+
+        std::string text = "=== ИЗМЕНЕНИЯ СОСТОЯНИЯ ===\n";
+        text += "Время: " + NetworkUtils::getCurrentTime() + "\n\n";
+        for (int id : dirty_programmers) {
+            const ProgrammerInfo* info;
+            size_t queued;
+            if (findProgrammerStatus(id, info, queued)) {
+                appendProgrammerStatus(text, *info, queued);
+            }
+        }
+
+        std::vector<Message> chunks;
+        splitStatusText(text, chunks);
+
+        for (int id : observer_ids) {
+            const auto& addr = observer_addresses[id];
+            for (Message& chunk : chunks) {
+                chunk.client_id = id;
+                status_pacer.enqueue(chunk, addr);
+            }
+        }
+    }
+
+    const std::vector<Message>& snapshotFrames() {
+        if (snapshot_cache_generation == status_generation &&
+            snapshot_cache_sequence == status_sequence) {
+            return snapshot_frames;
+        }
+
+        uint32_t total = static_cast<uint32_t>(programmers.size() + replicas.size());
+        snapshot_frames.assign(1, Message());
+        StatusStream::beginFrame(
+            snapshot_frames.back(), STATUS_SNAPSHOT, 0, status_sequence, total);
+
+        forEachProgrammerStatus([this, total](const ProgrammerInfo& info, size_t queued) {
+            if (!StatusStream::appendRecord(snapshot_frames.back(), info, queued)) {
+                snapshot_frames.push_back(Message());
+                StatusStream::beginFrame(
+                    snapshot_frames.back(), STATUS_SNAPSHOT, 0, status_sequence, total);
+                StatusStream::appendRecord(snapshot_frames.back(), info, queued);
+            }
+        });
+
+        snapshot_cache_generation = status_generation;
+        snapshot_cache_sequence = status_sequence;
+        return snapshot_frames;
+    }
+
+    void sendSnapshot(int observer_id, const Endpoint& addr) {
+        const std::vector<Message>& frames = snapshotFrames();
+        if (!status_pacer.reserve(addr, frames.size())) {
+            return;
+        }
+
+        Message frame;
+        for (const Message& cached : frames) {
+            frame = cached;
+            frame.client_id = observer_id;
+            status_pacer.enqueue(frame, addr, true);
+        }
+    }
+
+    void sendStatusDeltas() {
+        if (stream_observers.empty() && !multicastEnabled()) {
+            dirty_programmers.clear();
+            return;
+        }
+
+        std::vector<Message> frames;
+        bool frame_open = false;
+
+        for (int id : dirty_programmers) {
+            const ProgrammerInfo* info;
+            size_t queued;
+            if (!findProgrammerStatus(id, info, queued)) {
+                continue;
+            }
+
+            if (!frame_open || !StatusStream::appendRecord(frames.back(), *info, queued)) {
+                frames.push_back(Message());
+                StatusStream::beginFrame(frames.back(), STATUS_DELTA, 0, ++status_sequence, 0);
+                StatusStream::appendRecord(frames.back(), *info, queued);
+                frame_open = true;
+            }
+        }
+        dirty_programmers.clear();
+
+        for (int observer_id : stream_observers) {
+            const auto& addr = observer_addresses[observer_id];
+            for (Message& frame : frames) {
+                frame.client_id = observer_id;
+                status_pacer.enqueue(frame, addr);
+            }
+        }
+
+        if (multicastEnabled()) {
+            for (Message& frame : frames) {
+                frame.client_id = 0;
+                status_pacer.enqueue(frame, multicast_endpoint);
+            }
+        }
+    }
+
+    void appendProgrammerStatus(std::string& status, const ProgrammerInfo& info, size_t queued) {
+        status += "Программист: " + info.name + " (ID: " + std::to_string(info.id) + ")\n";
+        status += "  Состояние: ";
+
+        switch (info.state) {
+            case WRITING:
+                status += "Пишет программу";
+                break;
+            case WAITING_REVIEW:
+                status += "Ожидает проверки";
+                break;
+            case REVIEWING:
+                status += "Проверяет программу";
+                break;
+            case FIXING:
+                status += "Исправляет программу";
+                break;
+            case SLEEPING:
+                status += "Спит";
+                break;
+        }
+
+        status += "\n  Подключен: " + std::string(info.is_connected ? "Да" : "Нет") + "\n";
+        status += "  Текущая активность: " + info.current_activity + "\n";
+        status += "  Написано программ: " + std::to_string(info.programs_written) + "\n";
+        status += "  Проверено программ: " + std::to_string(info.programs_reviewed) + "\n";
+        status += "  Программ в очереди на проверку: " + std::to_string(queued) + "\n\n";
+    }
+
+    void sendStatus(const std::vector<int>& observer_ids) {
+        if (observer_ids.empty()) {
+            return;
+        }
+
+        const std::vector<Message>& chunks = statusChunks();
+        Message chunk;
+
+        for (int id : observer_ids) {
+            const auto& addr = observer_addresses[id];
+            for (const Message& cached : chunks) {
+                chunk = cached;
+                chunk.client_id = id;
+                status_pacer.enqueue(chunk, addr);
+            }
+        }
+    }
+};
+
+#endif
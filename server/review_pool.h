@@ -0,0 +1,152 @@
+#ifndef REVIEW_POOL_H
+#define REVIEW_POOL_H
+
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+#include "string_interner.h"
+
+struct ReviewRecord {
+    int program_id;
+    int author_id;
+    int reviewer_id;
+    time_t submitted_time;
+    uint32_t next;
+    StringInterner::Handle program_name;
+};
+
+struct ReviewQueue {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t count;
+
+    ReviewQueue() : head(UINT32_MAX), tail(UINT32_MAX), count(0) {}
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+};
+
+class ReviewPool {
+   public:
+    static const uint32_t NIL = UINT32_MAX;
+
+    explicit ReviewPool(size_t initial_capacity = 256) : free_head(NIL), in_use(0) {
+        grow(initial_capacity);
+    }
+
+    ReviewRecord& push(ReviewQueue& queue,
+                       int program_id,
+                       int author_id,
+                       int reviewer_id,
+                       StringInterner::Handle program_name) {
+        if (free_head == NIL) {
+            grow(records.size() * 2);
+        }
+
+        uint32_t index = free_head;
+        ReviewRecord& record = records[index];
+        free_head = record.next;
+        in_use++;
+
+        record.program_id = program_id;
+        record.author_id = author_id;
+        record.reviewer_id = reviewer_id;
+        record.submitted_time = 0;
+        record.next = NIL;
+        record.program_name = program_name;
+
+        if (queue.tail == NIL) {
+            queue.head = index;
+        } else {
+            records[queue.tail].next = index;
+        }
+        queue.tail = index;
+        queue.count++;
+
+        return record;
+    }
+
+    const ReviewRecord& front(const ReviewQueue& queue) const { return records[queue.head]; }
+
+    void pop(ReviewQueue& queue) {
+        uint32_t index = queue.head;
+        queue.head = records[index].next;
+        if (queue.head == NIL) {
+            queue.tail = NIL;
+        }
+        queue.count--;
+
+        records[index].next = free_head;
+        free_head = index;
+        in_use--;
+    }
+
+    void moveFront(ReviewQueue& from, ReviewQueue& to) {
+        uint32_t index = from.head;
+        from.head = records[index].next;
+        if (from.head == NIL) {
+            from.tail = NIL;
+        }
+        from.count--;
+
+        records[index].next = NIL;
+        if (to.tail == NIL) {
+            to.head = index;
+        } else {
+            records[to.tail].next = index;
+        }
+        to.tail = index;
+        to.count++;
+    }
+
+    void prependAll(ReviewQueue& from, ReviewQueue& to) {
+        if (from.empty()) {
+            return;
+        }
+
+        records[from.tail].next = to.head;
+        if (to.tail == NIL) {
+            to.tail = from.tail;
+        }
+        to.head = from.head;
+        to.count += from.count;
+        from = ReviewQueue();
+    }
+
+    template <typename Visitor>
+    void forEach(const ReviewQueue& queue, Visitor visit) const {
+        for (uint32_t index = queue.head; index != NIL; index = records[index].next) {
+            visit(records[index]);
+        }
+    }
+
+    void clear(ReviewQueue& queue) {
+        while (!queue.empty()) {
+            pop(queue);
+        }
+    }
+
+    size_t inUse() const { return in_use; }
+    size_t capacity() const { return records.size(); }
+
+   private:
+    void grow(size_t capacity) {
+        size_t first = records.size();
+        if (capacity <= first) {
+            capacity = first + 1;
+        }
+
+        records.resize(capacity);
+        for (size_t i = capacity; i-- > first;) {
+            records[i].next = free_head;
+            free_head = static_cast<uint32_t>(i);
+        }
+    }
+
+    std::vector<ReviewRecord> records;
+    uint32_t free_head;
+    size_t in_use;
+};
+
+#endif
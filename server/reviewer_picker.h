@@ -0,0 +1,179 @@
+#ifndef REVIEWER_PICKER_H
+#define REVIEWER_PICKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+enum AssignPolicy { ASSIGN_LEAST_QUEUE = 1, ASSIGN_TWO_CHOICES = 2, ASSIGN_ROUND_ROBIN = 3 };
+
+class ReviewerPicker {
+   public:
+    static const size_t NONE = SIZE_MAX;
+
+    explicit ReviewerPicker(AssignPolicy policy = ASSIGN_TWO_CHOICES, uint32_t seed = 1)
+        : policy(policy), rng(seed), cursor(0), min_load(0) {}
+
+    static bool parsePolicy(const std::string& value, AssignPolicy& policy) {
+        if (value == "least-queue") {
+            policy = ASSIGN_LEAST_QUEUE;
+        } else if (value == "two-choices") {
+            policy = ASSIGN_TWO_CHOICES;
+        } else if (value == "round-robin") {
+            policy = ASSIGN_ROUND_ROBIN;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    void add(size_t slot) {
+        if (slot >= position.size()) {
+            position.resize(slot + 1, size_t(NONE));
+        }
+        if (position[slot] != NONE) {
+            return;
+        }
+
+        position[slot] = members.size();
+        members.push_back(slot);
+        if (policy == ASSIGN_LEAST_QUEUE) {
+            insertByLoad(slot);
+        }
+    }
+
+    void remove(size_t slot) {
+        if (!contains(slot)) {
+            return;
+        }
+
+        size_t index = position[slot];
+        members[index] = members.back();
+        position[members[index]] = index;
+        members.pop_back();
+        position[slot] = NONE;
+        if (policy == ASSIGN_LEAST_QUEUE) {
+            eraseByLoad(slot);
+        }
+    }
+
+    void update(size_t slot, size_t queue_depth) {
+        if (policy != ASSIGN_LEAST_QUEUE) {
+            return;
+        }
+        if (slot >= load.size()) {
+            load.resize(slot + 1, 0);
+        }
+        if (load[slot] == queue_depth) {
+            return;
+        }
+
+        if (contains(slot)) {
+            eraseByLoad(slot);
+            load[slot] = queue_depth;
+            insertByLoad(slot);
+        } else {
+            load[slot] = queue_depth;
+        }
+    }
+
+    bool contains(size_t slot) const { return slot < position.size() && position[slot] != NONE; }
+
+    size_t size() const { return members.size(); }
+
+    size_t candidates(size_t exclude) const { return members.size() - (contains(exclude) ? 1 : 0); }
+
+    template <typename QueueDepth>
+    size_t pick(size_t exclude, QueueDepth depth) {
+        size_t count = candidates(exclude);
+        if (count == 0) {
+            return NONE;
+        }
+
+        switch (policy) {
+            case ASSIGN_LEAST_QUEUE:
+                return pickLeastLoaded(exclude);
+            case ASSIGN_ROUND_ROBIN: {
+                size_t slot = members[cursor++ % members.size()];
+                return slot != exclude ? slot : members[cursor++ % members.size()];
+            }
+            default: {
+                size_t first = sample(exclude, count);
+                size_t second = sample(exclude, count);
+                return depth(second) < depth(first) ? second : first;
+            }
+        }
+    }
+
+   private:
+    size_t pickLeastLoaded(size_t exclude) {
+        while (min_load < by_load.size() && by_load[min_load].empty()) {
+            min_load++;
+        }
+
+        for (size_t depth = min_load; depth < by_load.size(); depth++) {
+            const std::vector<size_t>& bucket = by_load[depth];
+            if (bucket.empty() || (bucket.size() == 1 && bucket[0] == exclude)) {
+                continue;
+            }
+
+            size_t index = cursor++ % bucket.size();
+            if (bucket[index] == exclude) {
+                index = (index + 1) % bucket.size();
+            }
+            return bucket[index];
+        }
+        return NONE;
+    }
+
+    void insertByLoad(size_t slot) {
+        if (slot >= load.size()) {
+            load.resize(slot + 1, 0);
+        }
+        if (slot >= load_position.size()) {
+            load_position.resize(slot + 1, size_t(NONE));
+        }
+
+        size_t depth = load[slot];
+        if (depth >= by_load.size()) {
+            by_load.resize(depth + 1);
+        }
+        load_position[slot] = by_load[depth].size();
+        by_load[depth].push_back(slot);
+        if (depth < min_load) {
+            min_load = depth;
+        }
+    }
+
+    void eraseByLoad(size_t slot) {
+        std::vector<size_t>& bucket = by_load[load[slot]];
+        size_t index = load_position[slot];
+        bucket[index] = bucket.back();
+        load_position[bucket[index]] = index;
+        bucket.pop_back();
+        load_position[slot] = NONE;
+    }
+
+    size_t sample(size_t exclude, size_t count) {
+        size_t index = std::uniform_int_distribution<size_t>(0, count - 1)(rng);
+        if (contains(exclude) && index >= position[exclude]) {
+            index++;
+        }
+        return members[index];
+    }
+
+    AssignPolicy policy;
+    std::mt19937 rng;
+    size_t cursor;
+    std::vector<size_t> members;
+    std::vector<size_t> position;
+
+    std::vector<size_t> load;
+    std::vector<size_t> load_position;
+    std::vector<std::vector<size_t>> by_load;
+    size_t min_load;
+};
+
+#endif
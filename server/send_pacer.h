@@ -0,0 +1,161 @@
+#ifndef SEND_PACER_H
+#define SEND_PACER_H
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "../common/endpoint.h"
+#include "../common/protocol.h"
+#include "../common/transport.h"
+
+class SendPacer {
+   public:
+    typedef Endpoint Destination;
+
+    SendPacer(double rate_per_sec, double burst, size_t max_queue)
+        : rate(rate_per_sec), burst(burst), max_queue(max_queue), queued(0), dropped(0) {}
+
+    bool enqueue(const Message& msg, const Destination& to, bool reserved = false) {
+        Bucket& bucket = buckets[to];
+        if (bucket.queue.empty() && bucket.last_refill_ms == 0) {
+            bucket.tokens = burst;
+        }
+
+        if (reserved ? bucket.reserved_queued >= bucket.reserved
+                     : bucket.queue.size() - bucket.reserved_queued >= max_queue) {
+            dropped++;
+            return false;
+        }
+
+        bucket.queue.push_back(Frame(msg, reserved));
+        if (reserved) {
+            bucket.reserved_queued++;
+        }
+        queued++;
+        return true;
+    }
+
+    int drain(Transport& transport, uint64_t now_ms) {
+        if (queued == 0) {
+            return 0;
+        }
+
+        batch.clear();
+        addrs.clear();
+
+        for (auto it = buckets.begin(); it != buckets.end();) {
+            Bucket& bucket = it->second;
+            refill(bucket, now_ms);
+
+            while (!bucket.queue.empty() && bucket.tokens >= 1.0) {
+                const Frame& frame = bucket.queue.front();
+                batch.push_back(frame.msg);
+                addrs.push_back(it->first);
+                if (frame.reserved) {
+                    bucket.reserved--;
+                    bucket.reserved_queued--;
+                }
+                bucket.queue.pop_front();
+                bucket.tokens -= 1.0;
+                queued--;
+            }
+
+            if (bucket.queue.empty() && bucket.reserved == 0 && bucket.tokens >= burst) {
+                it = buckets.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (batch.empty()) {
+            return 0;
+        }
+
+        return transport.sendMessages(batch, addrs);
+    }
+
+    int nextDelayMs(uint64_t now_ms) const {
+        if (queued == 0) {
+            return -1;
+        }
+
+        int delay = -1;
+
+        for (const auto& pair : buckets) {
+            const Bucket& bucket = pair.second;
+            if (bucket.queue.empty()) {
+                continue;
+            }
+
+            double tokens = bucket.tokens + (now_ms - bucket.last_refill_ms) * rate / 1000.0;
+            int wait = tokens >= 1.0 ? 0 : static_cast<int>((1.0 - tokens) * 1000.0 / rate) + 1;
+
+            if (delay < 0 || wait < delay) {
+                delay = wait;
+            }
+        }
+
+        return delay;
+    }
+
+    bool reserve(const Destination& to, size_t frames) {
+        Bucket& bucket = buckets[to];
+        if (bucket.reserved > 0) {
+            return false;
+        }
+
+        bucket.reserved = frames;
+        return true;
+    }
+
+    bool hasPending() const { return queued > 0; }
+
+    void clear() {
+        buckets.clear();
+        queued = 0;
+    }
+
+    size_t droppedCount() const { return dropped; }
+
+   private:
+    struct Frame {
+        Message msg;
+        bool reserved;
+
+        Frame(const Message& msg, bool reserved) : msg(msg), reserved(reserved) {}
+    };
+
+    struct Bucket {
+        std::deque<Frame> queue;
+        double tokens;
+        uint64_t last_refill_ms;
+        size_t reserved;
+        size_t reserved_queued;
+
+        Bucket() : tokens(0), last_refill_ms(0), reserved(0), reserved_queued(0) {}
+    };
+
+    void refill(Bucket& bucket, uint64_t now_ms) {
+        if (bucket.last_refill_ms != 0 && now_ms > bucket.last_refill_ms) {
+            bucket.tokens += (now_ms - bucket.last_refill_ms) * rate / 1000.0;
+            if (bucket.tokens > burst) {
+                bucket.tokens = burst;
+            }
+        }
+        bucket.last_refill_ms = now_ms;
+    }
+
+    double rate;
+    double burst;
+    size_t max_queue;
+    size_t queued;
+    size_t dropped;
+
+    std::map<Destination, Bucket> buckets;
+    std::vector<Message> batch;
+    std::vector<Destination> addrs;
+};
+
+#endif
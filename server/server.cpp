@@ -1,449 +1,147 @@
-#include <signal.h>
-#include <unistd.h>
-
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
-#include <map>
-#include <queue>
 #include <random>
-#include <vector>
-
-#include "../common/network_utils.h"
-#include "../common/protocol.h"
-
-class ProgrammersServer {
-   private:
-    int sockfd;
-    std::string server_ip;
-    int server_port;
-    bool running;
-
-    std::map<int, ProgrammerInfo> programmers;
-    std::map<int, std::pair<std::string, int>> programmer_addresses;
-    std::map<int, std::pair<std::string, int>> observer_addresses;
-
-    std::map<int, std::queue<ProgramReview>> review_queues;
-
-    int next_programmer_id;
-    int next_observer_id;
-    int next_program_id;
-
-    std::random_device rd;
-    std::mt19937 gen;
-
-    static ProgrammersServer* instance;
-
-   public:
-    ProgrammersServer(const std::string& ip, int port)
-        : server_ip(ip),
-          server_port(port),
-          running(false),
-          next_programmer_id(1),
-          next_observer_id(1000),
-          next_program_id(1),
-          gen(rd()) {
-        instance = this;
-        signal(SIGINT, signalHandler);
-        signal(SIGTERM, signalHandler);
-    }
-
-    static void signalHandler(int signal) {
-        if (instance) {
-            std::cout << "\nПолучен сигнал завершения. Останавливаем сервер..." << std::endl;
-            instance->shutdown();
-        }
-    }
-
-    bool start() {
-        sockfd = NetworkUtils::createUDPSocket();
-        if (sockfd < 0) {
-            return false;
-        }
-
-        if (!NetworkUtils::bindSocket(sockfd, server_ip, server_port)) {
-            close(sockfd);
-            return false;
-        }
-
-        std::cout << "Сервер запущен на " << server_ip << ":" << server_port << std::endl;
-        std::cout << "Для завершения работы нажмите Ctrl+C" << std::endl;
-
-        running = true;
-        mainLoop();
-
-        return true;
-    }
-
-    void shutdown() {
-        if (!running)
-            return;
-
-        std::cout << "Отправляем команду завершения всем клиентам..." << std::endl;
-
-        Message shutdown_msg;
-        shutdown_msg.type = SHUTDOWN;
-        shutdown_msg.client_id = 0;
-        strcpy(shutdown_msg.data, "Server is shutting down");
-
-        for (const auto& pair : programmer_addresses) {
-            NetworkUtils::sendMessage(sockfd, shutdown_msg, pair.second.first, pair.second.second);
-        }
-
-        for (const auto& pair : observer_addresses) {
-            NetworkUtils::sendMessage(sockfd, shutdown_msg, pair.second.first, pair.second.second);
-        }
-
-        sleep(2);
-
-        running = false;
-        close(sockfd);
-        std::cout << "Сервер остановлен." << std::endl;
-    }
+#include <string>
+
+#include "programmers_server.h"
+#include "sharded_server.h"
+
+static void printUsage(const char* program) {
+    std::cout << "Использование: " << program
+              << " <IP> <PORT> [--loop epoll|poll] [--transport socket|uring] [--workers N]"
+                 " [--multicast GROUP:PORT] [--multicast-if IP] [--status-interval MS]"
+                 " [--log-level debug|info|warn|error|off] [--log-sample N]"
+                 " [--log-file PATH | --log-binary PATH]"
+                 " [--assign least-queue|two-choices|round-robin] [--journal PATH]"
+              << std::endl;
+    std::cout << "Пример: " << program << " 127.0.0.1 8080" << std::endl;
+}
 
-   private:
-    void mainLoop() {
-        while (running) {
-            processMessages();
-            checkHeartbeats();
-            usleep(100000);
-        }
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
     }
 
-    void processMessages() {
-        Message msg;
-        std::string from_ip;
-        int from_port;
-
-        while (NetworkUtils::receiveMessage(sockfd, msg, from_ip, from_port)) {
-            NetworkUtils::printMessage("Получено: ", msg);
-
-            switch (msg.type) {
-                case REGISTER_PROGRAMMER:
-                    handleRegisterProgrammer(msg, from_ip, from_port);
-                    break;
-                case REGISTER_OBSERVER:
-                    handleRegisterObserver(msg, from_ip, from_port);
-                    break;
-                case SUBMIT_PROGRAM:
-                    handleSubmitProgram(msg, from_ip, from_port);
-                    break;
-                case REQUEST_REVIEW:
-                    handleRequestReview(msg, from_ip, from_port);
-                    break;
-                case REVIEW_RESULT:
-                    handleReviewResult(msg, from_ip, from_port);
-                    break;
-                case DISCONNECT:
-                    handleDisconnect(msg, from_ip, from_port);
-                    break;
-                case HEARTBEAT:
-                    handleHeartbeat(msg, from_ip, from_port);
-                    break;
-                default:
-                    std::cout << "Неизвестный тип сообщения: " << msg.type << std::endl;
+    std::string server_ip = argv[1];
+    int server_port = std::atoi(argv[2]);
+    ServerOptions options;
+    int workers = 1;
+    AsyncLog& log = AsyncLog::instance();
+    TrafficJournal journal;
+
+    for (int i = 3; i < argc; i++) {
+        std::string option = argv[i];
+
+        if (option == "--loop" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "epoll") {
+                options.loop_mode = LOOP_EPOLL;
+            } else if (value == "poll") {
+                options.loop_mode = LOOP_POLL;
+            } else {
+                std::cout << "Ошибка: неизвестный режим цикла '" << value << "'" << std::endl;
+                return 1;
             }
-        }
-    }
-
-    void handleRegisterProgrammer(const Message& msg, const std::string& ip, int port) {
-        int id = next_programmer_id++;
-        std::string name = std::string(msg.data);
-        if (name.empty()) {
-            name = "Программист" + std::to_string(id);
-        }
-
-        programmers[id] = ProgrammerInfo(id, name);
-        programmer_addresses[id] = std::make_pair(ip, port);
-        review_queues[id] = std::queue<ProgramReview>();
-
-        Message response;
-        response.type = REGISTER_PROGRAMMER;
-        response.client_id = id;
-        strcpy(response.data, name.c_str());
-
-        NetworkUtils::sendMessage(sockfd, response, ip, port);
-
-        std::cout << "Зарегистрирован программист " << name << " (ID: " << id << ") с адреса " << ip
-                  << ":" << port << std::endl;
-
-        broadcastStatusUpdate();
-    }
-
-    void handleRegisterObserver(const Message& msg, const std::string& ip, int port) {
-        int id = next_observer_id++;
-        observer_addresses[id] = std::make_pair(ip, port);
-
-        Message response;
-        response.type = REGISTER_OBSERVER;
-        response.client_id = id;
-        strcpy(response.data, "Observer registered");
-
-        NetworkUtils::sendMessage(sockfd, response, ip, port);
-
-        std::cout << "Зарегистрирован наблюдатель (ID: " << id << ") с адреса " << ip << ":" << port
-                  << std::endl;
-
-        sendFullStatusToObserver(id);
-    }
-
-    void handleSubmitProgram(const Message& msg, const std::string& ip, int port) {
-        int author_id = msg.client_id;
-        int target_id = msg.target_id;
-
-        if (programmers.find(author_id) == programmers.end() ||
-            programmers.find(target_id) == programmers.end()) {
-            std::cout << "Ошибка: неизвестный программист" << std::endl;
-            return;
-        }
-
-        int program_id = next_program_id++;
-        std::string program_name = std::string(msg.data);
-        if (program_name.empty()) {
-            program_name = "Программа" + std::to_string(program_id);
-        }
-
-        ProgramReview review(program_id, author_id, target_id, program_name);
-        review_queues[target_id].push(review);
-
-        programmers[author_id].state = WAITING_REVIEW;
-        programmers[author_id].current_program_id = program_id;
-        programmers[author_id].current_activity = "Ожидает проверки программы " + program_name;
-        programmers[author_id].last_activity = time(nullptr);
-
-        std::cout << "Программист " << programmers[author_id].name << " отправил программу '"
-                  << program_name << "' на проверку программисту " << programmers[target_id].name
-                  << std::endl;
-
-        if (programmer_addresses.find(target_id) != programmer_addresses.end()) {
-            Message notification;
-            notification.type = ASSIGNMENT_NOTIFICATION;
-            notification.client_id = target_id;
-            notification.program_id = program_id;
-            notification.target_id = author_id;
-            strcpy(notification.data, program_name.c_str());
-
-            auto& addr = programmer_addresses[target_id];
-            NetworkUtils::sendMessage(sockfd, notification, addr.first, addr.second);
-        }
-
-        broadcastStatusUpdate();
-    }
-
-    void handleRequestReview(const Message& msg, const std::string& ip, int port) {
-        int reviewer_id = msg.client_id;
-
-        if (programmers.find(reviewer_id) == programmers.end()) {
-            return;
-        }
-
-        if (review_queues[reviewer_id].empty()) {
-            Message response;
-            response.type = REQUEST_REVIEW;
-            response.client_id = reviewer_id;
-            response.program_id = 0;
-            strcpy(response.data, "No programs to review");
-
-            NetworkUtils::sendMessage(sockfd, response, ip, port);
-            return;
-        }
-
-        ProgramReview review = review_queues[reviewer_id].front();
-        review_queues[reviewer_id].pop();
-
-        Message response;
-        response.type = REQUEST_REVIEW;
-        response.client_id = reviewer_id;
-        response.program_id = review.program_id;
-        response.target_id = review.author_id;
-        strcpy(response.data, review.program_name.c_str());
-
-        NetworkUtils::sendMessage(sockfd, response, ip, port);
-
-        programmers[reviewer_id].state = REVIEWING;
-        programmers[reviewer_id].current_activity =
-            "Проверяет программу '" + review.program_name + "'";
-        programmers[reviewer_id].last_activity = time(nullptr);
-
-        std::cout << "Программист " << programmers[reviewer_id].name
-                  << " начал проверку программы '" << review.program_name << "' от "
-                  << programmers[review.author_id].name << std::endl;
-
-        broadcastStatusUpdate();
-    }
-
-    void handleReviewResult(const Message& msg, const std::string& ip, int port) {
-        int reviewer_id = msg.client_id;
-        int author_id = msg.target_id;
-        int program_id = msg.program_id;
-        ReviewResult result = msg.result;
-
-        if (programmers.find(reviewer_id) == programmers.end() ||
-            programmers.find(author_id) == programmers.end()) {
-            return;
-        }
-
-        programmers[reviewer_id].programs_reviewed++;
-        programmers[reviewer_id].state = WRITING;
-        programmers[reviewer_id].current_activity = "Пишет новую программу";
-        programmers[reviewer_id].last_activity = time(nullptr);
-
-        if (programmer_addresses.find(author_id) != programmer_addresses.end()) {
-            auto& addr = programmer_addresses[author_id];
-            NetworkUtils::sendMessage(sockfd, msg, addr.first, addr.second);
-        }
-
-        std::string result_str = (result == CORRECT) ? "ПРАВИЛЬНО" : "НЕПРАВИЛЬНО";
-        std::cout << "Программист " << programmers[reviewer_id].name
-                  << " проверил программу (ID: " << program_id << ") - результат: " << result_str
-                  << std::endl;
-
-        if (result == CORRECT) {
-            programmers[author_id].programs_written++;
-            programmers[author_id].state = WRITING;
-            programmers[author_id].current_activity = "Пишет новую программу";
-        } else {
-            programmers[author_id].state = FIXING;
-            programmers[author_id].current_activity =
-                "Исправляет программу (ID: " + std::to_string(program_id) + ")";
-        }
-        programmers[author_id].last_activity = time(nullptr);
-
-        broadcastStatusUpdate();
-    }
-
-    void handleDisconnect(const Message& msg, const std::string& ip, int port) {
-        int client_id = msg.client_id;
-
-        if (programmers.find(client_id) != programmers.end()) {
-            programmers[client_id].is_connected = false;
-            std::cout << "Программист " << programmers[client_id].name << " (ID: " << client_id
-                      << ") отключился" << std::endl;
-        } else if (observer_addresses.find(client_id) != observer_addresses.end()) {
-            observer_addresses.erase(client_id);
-            std::cout << "Наблюдатель (ID: " << client_id << ") отключился" << std::endl;
-        }
-
-        broadcastStatusUpdate();
-    }
-
-    void handleHeartbeat(const Message& msg, const std::string& ip, int port) {
-        int client_id = msg.client_id;
-
-        if (programmers.find(client_id) != programmers.end()) {
-            programmers[client_id].last_activity = time(nullptr);
-            programmers[client_id].is_connected = true;
-        }
-    }
-
-    void checkHeartbeats() {
-        time_t now = time(nullptr);
-
-        for (auto& pair : programmers) {
-            if (pair.second.is_connected && (now - pair.second.last_activity) > CLIENT_TIMEOUT) {
-                pair.second.is_connected = false;
-                std::cout << "Программист " << pair.second.name << " (ID: " << pair.first
-                          << ") отключился по таймауту" << std::endl;
-                broadcastStatusUpdate();
+        } else if (option == "--transport" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "socket") {
+                options.transport_mode = TRANSPORT_SOCKET;
+            } else if (value == "uring") {
+                options.transport_mode = TRANSPORT_URING;
+            } else {
+                std::cout << "Ошибка: неизвестный транспорт '" << value << "'" << std::endl;
+                return 1;
             }
-        }
-    }
-
-    void broadcastStatusUpdate() {
-        for (const auto& pair : observer_addresses) {
-            sendFullStatusToObserver(pair.first);
-        }
-    }
-
-    void sendFullStatusToObserver(int observer_id) {
-        if (observer_addresses.find(observer_id) == observer_addresses.end()) {
-            return;
-        }
-
-        std::string status = "=== СОСТОЯНИЕ СИСТЕМЫ ===\n";
-        status += "Время: " + NetworkUtils::getCurrentTime() + "\n\n";
-
-        for (const auto& pair : programmers) {
-            const ProgrammerInfo& info = pair.second;
-            status += "Программист: " + info.name + " (ID: " + std::to_string(info.id) + ")\n";
-            status += "  Состояние: ";
-
-            switch (info.state) {
-                case WRITING:
-                    status += "Пишет программу";
-                    break;
-                case WAITING_REVIEW:
-                    status += "Ожидает проверки";
-                    break;
-                case REVIEWING:
-                    status += "Проверяет программу";
-                    break;
-                case FIXING:
-                    status += "Исправляет программу";
-                    break;
-                case SLEEPING:
-                    status += "Спит";
-                    break;
+        } else if (option == "--workers" && i + 1 < argc) {
+            workers = std::atoi(argv[++i]);
+            if (workers <= 0) {
+                std::cout << "Ошибка: некорректное число потоков" << std::endl;
+                return 1;
             }
-
-            status += "\n  Подключен: " + std::string(info.is_connected ? "Да" : "Нет") + "\n";
-            status += "  Текущая активность: " + info.current_activity + "\n";
-            status += "  Написано программ: " + std::to_string(info.programs_written) + "\n";
-            status += "  Проверено программ: " + std::to_string(info.programs_reviewed) + "\n";
-            status += "  Программ в очереди на проверку: " +
-                      std::to_string(review_queues.at(info.id).size()) + "\n\n";
-        }
-
-        Message status_msg;
-        status_msg.type = STATUS_UPDATE;
-        status_msg.client_id = observer_id;
-
-        size_t pos = 0;
-        int part = 1;
-
-        while (pos < status.length()) {
-            size_t chunk_size = std::min(sizeof(status_msg.data) - 1, status.length() - pos);
-            memset(status_msg.data, 0, sizeof(status_msg.data));
-            status.copy(status_msg.data, chunk_size, pos);
-            status_msg.program_id = part++;
-
-            auto& addr = observer_addresses[observer_id];
-            NetworkUtils::sendMessage(sockfd, status_msg, addr.first, addr.second);
-
-            pos += chunk_size;
-
-            if (pos < status.length()) {
-                usleep(10000);
+        } else if (option == "--multicast" && i + 1 < argc) {
+            if (!NetworkUtils::parseEndpoint(
+                    argv[++i], options.multicast_group, options.multicast_port)) {
+                std::cout << "Ошибка: некорректная multicast-группа" << std::endl;
+                return 1;
+            }
+        } else if (option == "--multicast-if" && i + 1 < argc) {
+            options.multicast_interface = argv[++i];
+        } else if (option == "--status-interval" && i + 1 < argc) {
+            options.status_interval_ms = std::atoi(argv[++i]);
+            if (options.status_interval_ms < 0) {
+                std::cout << "Ошибка: некорректный интервал рассылки статуса" << std::endl;
+                return 1;
             }
+        } else if (option == "--assign" && i + 1 < argc) {
+            if (!ReviewerPicker::parsePolicy(argv[++i], options.assign_policy)) {
+                std::cout << "Ошибка: неизвестная политика назначения '" << argv[i] << "'"
+                          << std::endl;
+                return 1;
+            }
+        } else if (option == "--log-level" && i + 1 < argc) {
+            LogLevel level;
+            if (!AsyncLog::parseLevel(argv[++i], level)) {
+                std::cout << "Ошибка: неизвестный уровень журнала '" << argv[i] << "'"
+                          << std::endl;
+                return 1;
+            }
+            log.setLevel(level);
+        } else if (option == "--log-sample" && i + 1 < argc) {
+            int every = std::atoi(argv[++i]);
+            if (every <= 0) {
+                std::cout << "Ошибка: некорректная частота выборки журнала" << std::endl;
+                return 1;
+            }
+            log.setSampleEvery(static_cast<uint32_t>(every));
+        } else if ((option == "--log-file" || option == "--log-binary") && i + 1 < argc) {
+            std::string path = argv[++i];
+            bool opened = option == "--log-file" ? log.openText(path) : log.openBinary(path);
+            if (!opened) {
+                std::cout << "Ошибка: не удалось открыть журнал '" << path << "'" << std::endl;
+                return 1;
+            }
+        } else if (option == "--journal" && i + 1 < argc) {
+            std::string path = argv[++i];
+            options.random_seed = std::max(1u, std::random_device()());
+            if (!journal.open(path, options.random_seed)) {
+                std::cout << "Ошибка: не удалось открыть журнал трафика '" << path << "'"
+                          << std::endl;
+                return 1;
+            }
+            options.journal = &journal;
+        } else {
+            printUsage(argv[0]);
+            return 1;
         }
-
-        memset(status_msg.data, 0, sizeof(status_msg.data));
-        strcpy(status_msg.data, "END_OF_STATUS");
-        status_msg.program_id = 0;
-        auto& addr = observer_addresses[observer_id];
-        NetworkUtils::sendMessage(sockfd, status_msg, addr.first, addr.second);
     }
-};
 
-ProgrammersServer* ProgrammersServer::instance = nullptr;
+    if (server_port <= 0 || server_port > 65535) {
+        std::cout << "Ошибка: некорректный порт" << std::endl;
+        return 1;
+    }
 
-int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cout << "Использование: " << argv[0] << " <IP> <PORT>" << std::endl;
-        std::cout << "Пример: " << argv[0] << " 127.0.0.1 8080" << std::endl;
+    if (options.journal && workers > 1) {
+        std::cout << "Ошибка: --journal поддерживается только с одним потоком (--workers 1)"
+                  << std::endl;
         return 1;
     }
 
-    std::string server_ip = argv[1];
-    int server_port = std::atoi(argv[2]);
+    log.start();
 
-    if (server_port <= 0 || server_port > 65535) {
-        std::cout << "Ошибка: некорректный порт" << std::endl;
-        return 1;
+    bool started;
+    if (workers > 1) {
+        ShardedServer server(server_ip, server_port, workers, options);
+        started = server.start();
+    } else {
+        ProgrammersServer server(server_ip, server_port, options);
+        started = server.start();
     }
 
-    ProgrammersServer server(server_ip, server_port);
+    log.stop();
 
-    if (!server.start()) {
+    if (!started) {
         std::cout << "Ошибка запуска сервера" << std::endl;
         return 1;
     }
@@ -0,0 +1,32 @@
+#ifndef SERVER_CLOCK_H
+#define SERVER_CLOCK_H
+
+#include <cstdint>
+#include <ctime>
+
+#include "timer_wheel.h"
+
+class ServerClock {
+   public:
+    virtual ~ServerClock() {}
+
+    virtual uint64_t monotonicMs() const { return TimerWheel::monotonicMs(); }
+
+    virtual time_t wallTime() const { return time(nullptr); }
+};
+
+class ManualClock : public ServerClock {
+   public:
+    explicit ManualClock(uint64_t start_ms = 0) : now_ms(start_ms) {}
+
+    uint64_t monotonicMs() const override { return now_ms; }
+
+    time_t wallTime() const override { return static_cast<time_t>(now_ms / 1000); }
+
+    void set(uint64_t ms) { now_ms = ms; }
+
+   private:
+    uint64_t now_ms;
+};
+
+#endif
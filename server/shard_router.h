@@ -0,0 +1,110 @@
+#ifndef SHARD_ROUTER_H
+#define SHARD_ROUTER_H
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "../common/endpoint.h"
+#include "../common/protocol.h"
+#include "spsc_queue.h"
+
+enum ShardCommand {
+    SHARD_DELIVER = 1,
+    SHARD_SUBMIT = 2,
+    SHARD_SUBMIT_ACCEPTED = 3,
+    SHARD_REVIEW_RESULT = 4,
+    SHARD_REPLICA = 5,
+    SHARD_STOP = 6
+};
+
+struct ShardEnvelope {
+    ShardCommand command;
+    Message msg;
+    Endpoint peer;
+    WireFormat format;
+    ProgrammerInfo info;
+    size_t queue_depth;
+
+    ShardEnvelope() : command(SHARD_DELIVER), format(WIRE_COMPACT), queue_depth(0) {}
+
+    ShardEnvelope(ShardCommand cmd, const Message& m)
+        : command(cmd), msg(m), format(WIRE_COMPACT), queue_depth(0) {}
+};
+
+const size_t SHARD_QUEUE_CAPACITY = 1024;
+
+class ShardRouter {
+   public:
+    explicit ShardRouter(int count) : shard_count(count) {
+        for (int i = 0; i < count * count; i++) {
+            links.push_back(std::unique_ptr<SpscQueue<ShardEnvelope>>(
+                new SpscQueue<ShardEnvelope>(SHARD_QUEUE_CAPACITY)));
+        }
+
+        for (int i = 0; i < count; i++) {
+            int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (fd < 0) {
+                perror("eventfd failed");
+            }
+            wake_fds.push_back(fd);
+        }
+    }
+
+    ~ShardRouter() {
+        for (int fd : wake_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    int count() const { return shard_count; }
+
+    int shardOf(int programmer_id) const {
+        if (programmer_id <= 0) {
+            return 0;
+        }
+        return (programmer_id - 1) % shard_count;
+    }
+
+    int wakeFd(int shard) const { return wake_fds[shard]; }
+
+    bool push(int from, int to, const ShardEnvelope& envelope) {
+        return links[from * shard_count + to]->push(envelope);
+    }
+
+    bool pop(int to, ShardEnvelope& envelope) {
+        for (int from = 0; from < shard_count; from++) {
+            if (links[from * shard_count + to]->pop(envelope)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void wake(int shard) {
+        uint64_t one = 1;
+        if (write(wake_fds[shard], &one, sizeof(one)) != sizeof(one)) {
+            return;
+        }
+    }
+
+    void clearWake(int shard) {
+        uint64_t value;
+        if (read(wake_fds[shard], &value, sizeof(value)) != sizeof(value)) {
+            return;
+        }
+    }
+
+   private:
+    int shard_count;
+    std::vector<std::unique_ptr<SpscQueue<ShardEnvelope>>> links;
+    std::vector<int> wake_fds;
+};
+
+#endif
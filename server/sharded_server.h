@@ -0,0 +1,107 @@
+#ifndef SHARDED_SERVER_H
+#define SHARDED_SERVER_H
+
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_log.h"
+#include "event_loop.h"
+#include "programmers_server.h"
+#include "shard_router.h"
+
+class ShardedServer {
+   private:
+    std::string server_ip;
+    int server_port;
+    int worker_count;
+    ServerOptions options;
+
+   public:
+    ShardedServer(const std::string& ip,
+                  int port,
+                  int workers,
+                  const ServerOptions& server_options = ServerOptions())
+        : server_ip(ip), server_port(port), worker_count(workers), options(server_options) {}
+
+    bool start() {
+        std::vector<std::unique_ptr<ProgrammersServer>> shards;
+        ShardRouter router(worker_count);
+
+        for (int i = 0; i < worker_count; i++) {
+            shards.push_back(std::unique_ptr<ProgrammersServer>(
+                new ProgrammersServer(server_ip, server_port, options)));
+            shards.back()->attachShard(&router, i);
+        }
+
+        int signal_fd = EventLoop::createSignalFd({SIGINT, SIGTERM});
+        if (signal_fd < 0) {
+            return false;
+        }
+
+        LOG_LINE(LOG_INFO) << "Сервер запущен на " << server_ip << ":" << server_port << " ("
+                          << worker_count << " потоков)";
+        LOG_LINE(LOG_INFO) << "Для завершения работы нажмите Ctrl+C";
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < worker_count; i++) {
+            ProgrammersServer* shard = shards[i].get();
+            workers.push_back(std::thread([shard]() { shard->start(); }));
+            pinToCore(workers.back(), i);
+        }
+
+        waitForSignal(signal_fd);
+
+        LOG_LINE(LOG_INFO) << "Получен сигнал завершения. Останавливаем сервер...";
+
+        for (int i = 0; i < worker_count; i++) {
+            while (!router.push(i, i, ShardEnvelope(SHARD_STOP, Message()))) {
+                std::this_thread::yield();
+            }
+            router.wake(i);
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        close(signal_fd);
+        return true;
+    }
+
+   private:
+    static void waitForSignal(int signal_fd) {
+        struct pollfd pfd;
+        pfd.fd = signal_fd;
+        pfd.events = POLLIN;
+
+        while (true) {
+            if (poll(&pfd, 1, -1) > 0 && EventLoop::readSignalFd(signal_fd) != 0) {
+                return;
+            }
+        }
+    }
+
+    static void pinToCore(std::thread& thread, int index) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        if (cores == 0) {
+            return;
+        }
+
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(index % cores, &cpuset);
+
+        if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpuset), &cpuset) != 0) {
+            LOG_LINE(LOG_WARN) << "Не удалось закрепить поток " << index << " за ядром";
+        }
+    }
+};
+
+#endif
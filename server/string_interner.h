@@ -0,0 +1,134 @@
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../common/protocol.h"
+
+class StringInterner {
+   public:
+    typedef uint32_t Handle;
+
+    static const Handle NONE = UINT32_MAX;
+    static const size_t MAX_LENGTH = sizeof(Message::data) - 1;
+
+    explicit StringInterner(size_t initial_capacity = 256) : free_head(NONE), live(0) {
+        grow(initial_capacity);
+        buckets.assign(initial_capacity, Handle(NONE));
+    }
+
+    Handle acquire(const char* text) {
+        size_t len = strnlen(text, MAX_LENGTH);
+        uint32_t hash = hashOf(text, len);
+
+        for (Handle h = buckets[hash & (buckets.size() - 1)]; h != NONE; h = entries[h].next) {
+            Entry& entry = entries[h];
+            if (entry.hash == hash && entry.text[len] == '\0' &&
+                memcmp(entry.text, text, len) == 0) {
+                entry.refs++;
+                return h;
+            }
+        }
+
+        if (free_head == NONE) {
+            grow(entries.size() * 2);
+        }
+        if (live >= buckets.size()) {
+            rehash(buckets.size() * 2);
+        }
+
+        Handle h = free_head;
+        Entry& entry = entries[h];
+        free_head = entry.next;
+
+        entry.refs = 1;
+        entry.hash = hash;
+        memcpy(entry.text, text, len);
+        entry.text[len] = '\0';
+
+        size_t bucket = hash & (buckets.size() - 1);
+        entry.next = buckets[bucket];
+        buckets[bucket] = h;
+        live++;
+
+        return h;
+    }
+
+    void retain(Handle h) {
+        if (h != NONE) {
+            entries[h].refs++;
+        }
+    }
+
+    void release(Handle h) {
+        if (h == NONE || --entries[h].refs > 0) {
+            return;
+        }
+
+        Handle* link = &buckets[entries[h].hash & (buckets.size() - 1)];
+        while (*link != h) {
+            link = &entries[*link].next;
+        }
+        *link = entries[h].next;
+
+        entries[h].next = free_head;
+        free_head = h;
+        live--;
+    }
+
+    const char* get(Handle h) const { return h == NONE ? "" : entries[h].text; }
+
+    size_t size() const { return live; }
+
+   private:
+    struct Entry {
+        uint32_t refs;
+        uint32_t hash;
+        Handle next;
+        char text[MAX_LENGTH + 1];
+    };
+
+    static uint32_t hashOf(const char* text, size_t len) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < len; i++) {
+            hash ^= static_cast<uint8_t>(text[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    void grow(size_t capacity) {
+        size_t first = entries.size();
+        if (capacity <= first) {
+            capacity = first + 1;
+        }
+
+        entries.resize(capacity);
+        for (size_t i = capacity; i-- > first;) {
+            entries[i].refs = 0;
+            entries[i].next = free_head;
+            free_head = static_cast<Handle>(i);
+        }
+    }
+
+    void rehash(size_t count) {
+        buckets.assign(count, Handle(NONE));
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].refs == 0) {
+                continue;
+            }
+            size_t bucket = entries[i].hash & (count - 1);
+            entries[i].next = buckets[bucket];
+            buckets[bucket] = static_cast<Handle>(i);
+        }
+    }
+
+    std::vector<Entry> entries;
+    std::vector<Handle> buckets;
+    Handle free_head;
+    size_t live;
+};
+
+#endif
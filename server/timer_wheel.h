@@ -0,0 +1,234 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <time.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class TimerWheel {
+   public:
+    typedef uint64_t TimerId;
+    typedef std::function<void()> Callback;
+
+    static const TimerId INVALID_TIMER = 0;
+
+    explicit TimerWheel(uint64_t tick_ms, uint64_t now_ms = monotonicMs())
+        : tick_ms(tick_ms), current_tick(now_ms / tick_ms), active_count(0) {
+        slots.assign(LEVELS * SLOTS, uint32_t(NIL));
+    }
+
+    static uint64_t monotonicMs() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+    }
+
+    TimerId schedule(uint64_t delay_ms, const Callback& callback) {
+        uint32_t index;
+        if (free_nodes.empty()) {
+            index = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(Node());
+        } else {
+            index = free_nodes.back();
+            free_nodes.pop_back();
+        }
+
+        Node& node = nodes[index];
+        node.generation++;
+        node.callback = callback;
+        node.active = true;
+        active_count++;
+
+        insert(index, current_tick + ticksFor(delay_ms));
+        return makeId(index, node.generation);
+    }
+
+    bool reschedule(TimerId id, uint64_t delay_ms) {
+        uint32_t index;
+        if (!resolve(id, index)) {
+            return false;
+        }
+
+        unlink(index);
+        insert(index, current_tick + ticksFor(delay_ms));
+        return true;
+    }
+
+    bool cancel(TimerId id) {
+        uint32_t index;
+        if (!resolve(id, index)) {
+            return false;
+        }
+
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    bool isActive(TimerId id) const {
+        uint32_t index;
+        return resolve(id, index);
+    }
+
+    size_t advance(uint64_t now_ms = monotonicMs()) {
+        uint64_t target_tick = now_ms / tick_ms;
+        size_t fired = 0;
+
+        while (current_tick < target_tick) {
+            current_tick++;
+
+            if ((current_tick & MASK) == 0) {
+                cascade(1);
+            }
+
+            fired += fireSlot(static_cast<uint32_t>(current_tick & MASK));
+        }
+
+        return fired;
+    }
+
+    size_t size() const { return active_count; }
+
+    uint64_t tickMs() const { return tick_ms; }
+
+   private:
+    static const int BITS = 6;
+    static const uint32_t SLOTS = 1u << BITS;
+    static const uint64_t MASK = SLOTS - 1;
+    static const int LEVELS = 4;
+    static const uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Node {
+        uint64_t expiry_tick;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t slot;
+        uint32_t generation;
+        bool active;
+        Callback callback;
+
+        Node() : expiry_tick(0), prev(NIL), next(NIL), slot(NIL), generation(0), active(false) {}
+    };
+
+    static TimerId makeId(uint32_t index, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(index) + 1);
+    }
+
+    bool resolve(TimerId id, uint32_t& index) const {
+        if (id == INVALID_TIMER) {
+            return false;
+        }
+
+        index = static_cast<uint32_t>((id & 0xFFFFFFFFu) - 1);
+        uint32_t generation = static_cast<uint32_t>(id >> 32);
+
+        return index < nodes.size() && nodes[index].active &&
+               nodes[index].generation == generation;
+    }
+
+    uint64_t ticksFor(uint64_t delay_ms) const {
+        uint64_t ticks = (delay_ms + tick_ms - 1) / tick_ms;
+        return ticks == 0 ? 1 : ticks;
+    }
+
+    uint32_t slotFor(uint64_t expiry_tick) const {
+        uint64_t delta = expiry_tick - current_tick;
+
+        for (int level = 0; level < LEVELS - 1; level++) {
+            if (delta < (static_cast<uint64_t>(1) << (BITS * (level + 1)))) {
+                return level * SLOTS + ((expiry_tick >> (BITS * level)) & MASK);
+            }
+        }
+
+        uint64_t max_tick = current_tick + (static_cast<uint64_t>(1) << (BITS * LEVELS)) - 1;
+        uint64_t capped = expiry_tick < max_tick ? expiry_tick : max_tick;
+        return (LEVELS - 1) * SLOTS + ((capped >> (BITS * (LEVELS - 1))) & MASK);
+    }
+
+    void insert(uint32_t index, uint64_t expiry_tick) {
+        Node& node = nodes[index];
+        node.expiry_tick = expiry_tick;
+        node.slot = slotFor(expiry_tick);
+        node.prev = NIL;
+        node.next = slots[node.slot];
+
+        if (node.next != NIL) {
+            nodes[node.next].prev = index;
+        }
+        slots[node.slot] = index;
+    }
+
+    void unlink(uint32_t index) {
+        Node& node = nodes[index];
+
+        if (node.prev != NIL) {
+            nodes[node.prev].next = node.next;
+        } else {
+            slots[node.slot] = node.next;
+        }
+
+        if (node.next != NIL) {
+            nodes[node.next].prev = node.prev;
+        }
+
+        node.prev = NIL;
+        node.next = NIL;
+        node.slot = NIL;
+    }
+
+    void release(uint32_t index) {
+        Node& node = nodes[index];
+        node.active = false;
+        node.callback = Callback();
+        free_nodes.push_back(index);
+        active_count--;
+    }
+
+    void cascade(int level) {
+        uint32_t slot_index = static_cast<uint32_t>((current_tick >> (BITS * level)) & MASK);
+
+        if (slot_index == 0 && level + 1 < LEVELS) {
+            cascade(level + 1);
+        }
+
+        uint32_t slot = level * SLOTS + slot_index;
+        uint32_t index = slots[slot];
+        slots[slot] = NIL;
+
+        while (index != NIL) {
+            uint32_t next = nodes[index].next;
+            insert(index, nodes[index].expiry_tick);
+            index = next;
+        }
+    }
+
+    size_t fireSlot(uint32_t slot) {
+        size_t fired = 0;
+
+        while (slots[slot] != NIL) {
+            uint32_t index = slots[slot];
+            unlink(index);
+
+            Callback callback;
+            callback.swap(nodes[index].callback);
+            release(index);
+
+            callback();
+            fired++;
+        }
+
+        return fired;
+    }
+
+    uint64_t tick_ms;
+    uint64_t current_tick;
+    size_t active_count;
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> free_nodes;
+    std::vector<uint32_t> slots;
+};
+
+#endif
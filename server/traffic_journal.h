@@ -0,0 +1,146 @@
+#ifndef TRAFFIC_JOURNAL_H
+#define TRAFFIC_JOURNAL_H
+
+#include <time.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+#include "../common/network_utils.h"
+
+struct JournalRecordHeader {
+    uint64_t time_us;
+    uint16_t length;
+    uint8_t flags;
+    uint8_t address_length;
+};
+
+struct JournalRecord {
+    uint64_t time_us;
+    Endpoint from;
+    bool truncated;
+    size_t length;
+    char payload[BUFFER_SIZE];
+};
+
+class TrafficJournal : public DatagramTap {
+   public:
+    static const uint32_t VERSION = 2;
+    static const uint64_t FLUSH_INTERVAL_US = 1000000;
+    static const uint8_t TRUNCATED = 1;
+
+    TrafficJournal() : file(nullptr), flushed_us(0) {}
+
+    ~TrafficJournal() { close(); }
+
+    bool open(const std::string& path, uint32_t seed) {
+        file = fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+
+        setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        uint32_t header[3] = {MAGIC, VERSION, seed};
+        if (fwrite(header, sizeof(header), 1, file) != 1) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (file) {
+            fclose(file);
+            file = nullptr;
+        }
+    }
+
+    void capture(const char* data, size_t length, bool truncated, const Endpoint& from) override {
+        uint64_t& batch_us = batchUs();
+        if (batch_us == 0) {
+            batch_us = monotonicUs();
+        }
+
+        JournalRecordHeader header = JournalRecordHeader();
+        header.time_us = batch_us;
+        header.length = static_cast<uint16_t>(std::min<size_t>(length, BUFFER_SIZE));
+        header.flags = truncated ? TRUNCATED : 0;
+        header.address_length = static_cast<uint8_t>(from.size());
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file) {
+            return;
+        }
+
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(from.data(), 1, header.address_length, file);
+        fwrite(data, 1, header.length, file);
+    }
+
+    void endBatch() {
+        uint64_t& batch_us = batchUs();
+        if (batch_us == 0) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (file && batch_us - flushed_us >= FLUSH_INTERVAL_US) {
+            fflush(file);
+            flushed_us = batch_us;
+        }
+        batch_us = 0;
+    }
+
+    static uint64_t monotonicUs() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    static bool readHeader(FILE* file, uint32_t& seed) {
+        uint32_t header[3];
+        if (fread(header, sizeof(header), 1, file) != 1 || header[0] != MAGIC ||
+            header[1] != VERSION) {
+            return false;
+        }
+        seed = header[2];
+        return true;
+    }
+
+    static bool readRecord(FILE* file, JournalRecord& record) {
+        JournalRecordHeader header;
+        if (fread(&header, sizeof(header), 1, file) != 1 ||
+            header.length > sizeof(record.payload) ||
+            header.address_length > Endpoint::capacity()) {
+            return false;
+        }
+
+        if (fread(record.from.data(), 1, header.address_length, file) != header.address_length ||
+            fread(record.payload, 1, header.length, file) != header.length) {
+            return false;
+        }
+
+        record.time_us = header.time_us;
+        record.from.resize(header.address_length);
+        record.truncated = (header.flags & TRUNCATED) != 0;
+        record.length = header.length;
+        return true;
+    }
+
+   private:
+    static const uint32_t MAGIC = 0x4a504455;
+
+    static uint64_t& batchUs() {
+        thread_local uint64_t batch_us = 0;
+        return batch_us;
+    }
+
+    FILE* file;
+    uint64_t flushed_us;
+    std::mutex mutex;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#!/bin/bash
+
+# Сверка сводки симулятора с сетевым сервером на одном seed
+
+set -u
+
+cd "$(dirname "$0")/.."
+
+PROGRAMMERS=${1:-50}
+SECONDS_TO_RUN=${2:-120}
+SEED=${3:-7}
+PORT=${CROSSCHECK_PORT:-9700}
+TOLERANCE=${CROSSCHECK_TOLERANCE:-0.25}
+
+SERVER_LOG=build/crosscheck_server.log
+SWARM_LOG=build/crosscheck_swarm.log
+
+build/server 127.0.0.1 "$PORT" --log-level warn > "$SERVER_LOG" 2>&1 &
+server=$!
+sleep 0.5
+
+build/programmer Сверка 127.0.0.1 "$PORT" $((PORT + 1)) --swarm "$PROGRAMMERS" --seed "$SEED" \
+    > "$SWARM_LOG" 2>&1 &
+swarm=$!
+sleep "$SECONDS_TO_RUN"
+
+kill -INT "$swarm"
+wait "$swarm"
+kill -INT "$server"
+wait "$server"
+
+network=$(grep "Рой:" "$SWARM_LOG" | tail -1)
+simulated=$(build/simulate --programmers "$PROGRAMMERS" --duration "${SECONDS_TO_RUN}s" \
+    --seed "$SEED" | grep "Рой:" | tail -1)
+
+echo "Сеть:      $network"
+echo "Симулятор: $simulated"
+
+counts() {
+    sed -n 's/.*принято программ \([0-9]*\), проверено \([0-9]*\).*/\1 \2/p'
+}
+
+read -r net_written net_reviewed <<< "$(echo "$network" | counts)"
+read -r sim_written sim_reviewed <<< "$(echo "$simulated" | counts)"
+
+if [ -z "${net_written:-}" ] || [ -z "${sim_written:-}" ]; then
+    echo "Ошибка: не удалось получить сводку роя"
+    exit 1
+fi
+
+awk -v nw="$net_written" -v nr="$net_reviewed" -v sw="$sim_written" -v sr="$sim_reviewed" \
+    -v tol="$TOLERANCE" '
+    function off(a, b) { return b == 0 ? (a == 0 ? 0 : 1) : (a > b ? a - b : b - a) / b }
+    BEGIN {
+        printf "Расхождение: принято %.1f%%, проверено %.1f%% (допуск %.0f%%)\n",
+               100 * off(sw, nw), 100 * off(sr, nr), 100 * tol
+        exit (off(sw, nw) > tol || off(sr, nr) > tol) ? 1 : 0
+    }'
@@ -0,0 +1,495 @@
+#include <poll.h>
+#include <signal.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/network_utils.h"
+#include "../common/protocol.h"
+
+enum LoadKind { LOAD_SUBMIT = 0, LOAD_REQUEST = 1, LOAD_RESULT = 2, LOAD_HEARTBEAT = 3 };
+
+const int LOAD_KINDS = 4;
+const char* const LOAD_NAMES[LOAD_KINDS] = {
+    "SUBMIT_PROGRAM", "REQUEST_REVIEW", "REVIEW_RESULT", "HEARTBEAT"};
+
+const int REGISTER_WINDOW = 64;
+const int REGISTER_TIMEOUT_MS = 2000;
+const size_t LOAD_BATCH_SIZE = 64;
+const int SOCKET_BUFFER_BYTES = 4 << 20;
+const uint64_t DRAIN_US = 1000000;
+const uint64_t GENERATE_CHUNK = 4 * LOAD_BATCH_SIZE;
+const size_t SLOT_PROBES = 32;
+
+struct LoadOptions {
+    int programmers;
+    double rate;
+    double duration_s;
+    int timeout_ms;
+    double mix[LOAD_KINDS];
+
+    LoadOptions() : programmers(1000), rate(10000.0), duration_s(10.0), timeout_ms(1000) {
+        std::fill(mix, mix + LOAD_KINDS, 1.0);
+    }
+};
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void onSignal(int) { interrupted = 1; }
+
+class LoadGenerator {
+   private:
+    struct Outstanding {
+        uint64_t sent_us;
+        LoadKind kind;
+        size_t index;
+    };
+
+    struct KindStats {
+        uint64_t sent;
+        uint64_t dropped;
+        std::vector<double> rtt_us;
+
+        KindStats() : sent(0), dropped(0) {}
+    };
+
+    LoadOptions options;
+    int sockfd;
+    Endpoint server;
+
+    std::vector<int> ids;
+    std::unordered_map<int, size_t> index_by_id;
+
+    std::vector<uint64_t> pending[LOAD_KINDS];
+    std::deque<Outstanding> in_flight;
+    KindStats stats[LOAD_KINDS];
+    uint64_t late_replies;
+    uint64_t skipped;
+    uint64_t send_errors;
+    size_t heartbeat_cursor;
+
+    std::vector<Message> outbox;
+    std::vector<Endpoint> outbox_peers;
+    std::vector<Message> receive_batch;
+    std::vector<Endpoint> receive_sources;
+
+    std::mt19937 gen;
+    std::discrete_distribution<int> pick_kind;
+    uint64_t start_us;
+    uint64_t sent_until_us;
+
+   public:
+    LoadGenerator(const LoadOptions& load_options, int fd, const Endpoint& server_endpoint)
+        : options(load_options),
+          sockfd(fd),
+          server(server_endpoint),
+          late_replies(0),
+          skipped(0),
+          send_errors(0),
+          heartbeat_cursor(0),
+          receive_batch(LOAD_BATCH_SIZE),
+          gen(12345),
+          pick_kind(options.mix, options.mix + LOAD_KINDS),
+          start_us(0),
+          sent_until_us(0) {}
+
+    static uint64_t nowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    bool registerProgrammers() {
+        int sent = 0;
+        uint64_t deadline = nowUs() + REGISTER_TIMEOUT_MS * 1000ULL;
+
+        while (static_cast<int>(ids.size()) < options.programmers && nowUs() < deadline) {
+            while (sent < options.programmers &&
+                   sent - static_cast<int>(ids.size()) < REGISTER_WINDOW) {
+                Message request;
+                request.type = REGISTER_PROGRAMMER;
+                snprintf(request.data, sizeof(request.data), "load_%d", sent);
+                queue(request);
+                sent++;
+            }
+            flush();
+
+            waitSocket(10);
+            size_t before = ids.size();
+            receive();
+            if (ids.size() > before) {
+                deadline = nowUs() + REGISTER_TIMEOUT_MS * 1000ULL;
+            }
+        }
+
+        for (int kind = 0; kind < LOAD_KINDS; kind++) {
+            pending[kind].assign(ids.size(), 0);
+        }
+        return static_cast<int>(ids.size()) == options.programmers;
+    }
+
+    void run() {
+        uint64_t total = static_cast<uint64_t>(options.rate * options.duration_s);
+        uint64_t generated = 0;
+        start_us = nowUs();
+        uint64_t end_us = start_us + static_cast<uint64_t>(options.duration_s * 1e6);
+
+        while (!interrupted) {
+            uint64_t now = nowUs();
+            if (generated >= total && (in_flight.empty() || now >= end_us + DRAIN_US)) {
+                break;
+            }
+
+            uint64_t due = static_cast<uint64_t>((now - start_us) * options.rate / 1e6) + 1;
+            due = std::min(std::min(total, due), generated + GENERATE_CHUNK);
+            while (generated < due) {
+                generate(intendedUs(generated));
+                generated++;
+                if (outbox.size() == LOAD_BATCH_SIZE) {
+                    flush();
+                }
+            }
+            flush();
+            if (generated == total && sent_until_us == 0) {
+                sent_until_us = nowUs();
+            }
+
+            receive();
+            expire(nowUs() - options.timeout_ms * 1000ULL);
+
+            int timeout_ms = 1;
+            if (generated < total) {
+                uint64_t next = intendedUs(generated);
+                now = nowUs();
+                timeout_ms = next > now ? static_cast<int>((next - now) / 1000) : 0;
+            }
+            waitSocket(timeout_ms);
+        }
+
+        expire(UINT64_MAX);
+    }
+
+    void report() {
+        double elapsed_s = ((sent_until_us != 0 ? sent_until_us : nowUs()) - start_us) / 1e6;
+        uint64_t sent = 0;
+        uint64_t replies = 0;
+        uint64_t dropped = 0;
+        for (const KindStats& kind : stats) {
+            sent += kind.sent;
+            replies += kind.rtt_us.size();
+            dropped += kind.dropped;
+        }
+
+        printf("Программистов %zu, цель %.0f сообщений/с: отправлено %llu за %.2f с "
+               "(%.0f сообщений/с), ответов %llu, потеряно %llu, поздних ответов %llu, "
+               "пропущено без свободного ID %llu, ошибок отправки %llu\n",
+               ids.size(),
+               options.rate,
+               static_cast<unsigned long long>(sent),
+               elapsed_s,
+               sent / elapsed_s,
+               static_cast<unsigned long long>(replies),
+               static_cast<unsigned long long>(dropped),
+               static_cast<unsigned long long>(late_replies),
+               static_cast<unsigned long long>(skipped),
+               static_cast<unsigned long long>(send_errors));
+
+        printf("%-16s %10s %10s %9s %10s %10s %10s\n",
+               "type", "sent", "replies", "dropped", "p50_us", "p99_us", "p999_us");
+        for (int kind = 0; kind < LOAD_KINDS; kind++) {
+            KindStats& kind_stats = stats[kind];
+            if (kind == LOAD_HEARTBEAT) {
+                printf("%-16s %10llu %10s %9s %10s %10s %10s\n",
+                       LOAD_NAMES[kind],
+                       static_cast<unsigned long long>(kind_stats.sent),
+                       "-", "-", "-", "-", "-");
+                continue;
+            }
+
+            std::vector<double>& rtt = kind_stats.rtt_us;
+            std::sort(rtt.begin(), rtt.end());
+            printf("%-16s %10llu %10zu %9llu %10.1f %10.1f %10.1f\n",
+                   LOAD_NAMES[kind],
+                   static_cast<unsigned long long>(kind_stats.sent),
+                   rtt.size(),
+                   static_cast<unsigned long long>(kind_stats.dropped),
+                   percentile(rtt, 0.50),
+                   percentile(rtt, 0.99),
+                   percentile(rtt, 0.999));
+        }
+    }
+
+   private:
+    uint64_t intendedUs(uint64_t sequence) const {
+        return start_us + static_cast<uint64_t>(sequence * 1e6 / options.rate);
+    }
+
+    static double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+    }
+
+    void generate(uint64_t intended_us) {
+        LoadKind kind = static_cast<LoadKind>(pick_kind(gen));
+        Message msg;
+        msg.type = HEARTBEAT;
+
+        if (kind == LOAD_HEARTBEAT) {
+            msg.client_id = ids[heartbeat_cursor];
+            heartbeat_cursor = (heartbeat_cursor + 1) % ids.size();
+            strcpy(msg.data, "alive");
+            stats[kind].sent++;
+            queue(msg);
+            return;
+        }
+
+        size_t index;
+        if (!freeSlot(kind, index)) {
+            skipped++;
+            return;
+        }
+        size_t other = (index + 1 + gen() % (ids.size() - 1)) % ids.size();
+
+        switch (kind) {
+            case LOAD_SUBMIT:
+                msg.type = SUBMIT_PROGRAM;
+                msg.client_id = ids[index];
+                msg.target_id = ANY_REVIEWER;
+                strcpy(msg.data, "load_program");
+                break;
+            case LOAD_REQUEST:
+                msg.type = REQUEST_REVIEW;
+                msg.client_id = ids[index];
+                break;
+            case LOAD_RESULT:
+                msg.type = REVIEW_RESULT;
+                msg.client_id = ids[other];
+                msg.target_id = ids[index];
+                msg.program_id = 1;
+                msg.result = gen() % 100 < 70 ? CORRECT : INCORRECT;
+                strcpy(msg.data, "Program is correct");
+                break;
+            default:
+                break;
+        }
+
+        pending[kind][index] = intended_us;
+        in_flight.push_back(Outstanding{intended_us, kind, index});
+        stats[kind].sent++;
+        queue(msg);
+    }
+
+    bool freeSlot(LoadKind kind, size_t& index) {
+        size_t start = gen() % ids.size();
+        for (size_t i = 0; i < std::min(ids.size(), SLOT_PROBES); i++) {
+            index = (start + i) % ids.size();
+            if (pending[kind][index] == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void queue(const Message& msg) {
+        outbox.push_back(msg);
+        outbox_peers.push_back(server);
+    }
+
+    void flush() {
+        if (outbox.empty()) {
+            return;
+        }
+
+        int sent = NetworkUtils::sendMessages(sockfd, outbox, outbox_peers);
+        send_errors += outbox.size() - static_cast<size_t>(sent);
+        outbox.clear();
+        outbox_peers.clear();
+    }
+
+    void waitSocket(int timeout_ms) {
+        struct pollfd pfd;
+        pfd.fd = sockfd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        poll(&pfd, 1, timeout_ms);
+    }
+
+    void receive() {
+        int count;
+        do {
+            count = NetworkUtils::receiveMessages(sockfd, receive_batch, receive_sources);
+            uint64_t now = nowUs();
+            for (int i = 0; i < count; i++) {
+                handleReply(receive_batch[i], now);
+            }
+        } while (count == static_cast<int>(LOAD_BATCH_SIZE));
+    }
+
+    void handleReply(const Message& msg, uint64_t now) {
+        switch (msg.type) {
+            case REGISTER_PROGRAMMER:
+                if (index_by_id.find(msg.client_id) == index_by_id.end()) {
+                    index_by_id[msg.client_id] = ids.size();
+                    ids.push_back(msg.client_id);
+                }
+                return;
+            case ASSIGNMENT_NOTIFICATION:
+                complete(LOAD_SUBMIT, msg.target_id, now);
+                return;
+            case REQUEST_REVIEW:
+                complete(LOAD_REQUEST, msg.client_id, now);
+                return;
+            case REVIEW_RESULT:
+                complete(LOAD_RESULT, msg.target_id, now);
+                return;
+            case SHUTDOWN:
+                interrupted = 1;
+                return;
+            default:
+                return;
+        }
+    }
+
+    void complete(LoadKind kind, int id, uint64_t now) {
+        auto it = index_by_id.find(id);
+        if (it == index_by_id.end() || pending[kind].empty() || pending[kind][it->second] == 0) {
+            late_replies++;
+            return;
+        }
+
+        uint64_t& sent_us = pending[kind][it->second];
+        uint64_t rtt_us = now > sent_us ? now - sent_us : 0;
+        if (rtt_us > options.timeout_ms * 1000ULL) {
+            stats[kind].dropped++;
+        } else {
+            stats[kind].rtt_us.push_back(static_cast<double>(rtt_us));
+        }
+        sent_us = 0;
+    }
+
+    void expire(uint64_t sent_before_us) {
+        while (!in_flight.empty() && in_flight.front().sent_us <= sent_before_us) {
+            const Outstanding& entry = in_flight.front();
+            uint64_t& sent_us = pending[entry.kind][entry.index];
+            if (sent_us == entry.sent_us) {
+                stats[entry.kind].dropped++;
+                sent_us = 0;
+            }
+            in_flight.pop_front();
+        }
+    }
+};
+
+static bool parseMix(const std::string& value, double* mix) {
+    size_t pos = 0;
+    for (int kind = 0; kind < LOAD_KINDS; kind++) {
+        size_t end = value.find(':', pos);
+        if ((end == std::string::npos) != (kind == LOAD_KINDS - 1)) {
+            return false;
+        }
+
+        std::string part = value.substr(pos, end == std::string::npos ? end : end - pos);
+        char* tail = nullptr;
+        mix[kind] = std::strtod(part.c_str(), &tail);
+        if (part.empty() || *tail != '\0' || mix[kind] < 0) {
+            return false;
+        }
+        pos = end + 1;
+    }
+    return mix[0] + mix[1] + mix[2] + mix[3] > 0;
+}
+
+static void printUsage(const char* program) {
+    std::cout << "Использование: " << program
+              << " <SERVER_IP> <SERVER_PORT> [--programmers N] [--rate MSG_PER_S]"
+                 " [--duration S] [--timeout MS] [--mix SUBMIT:REQUEST:RESULT:HEARTBEAT]"
+              << std::endl;
+    std::cout << "Пример: " << program << " 127.0.0.1 8080 --programmers 5000 --rate 50000"
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string server_ip = argv[1];
+    int server_port = std::atoi(argv[2]);
+    LoadOptions options;
+
+    for (int i = 3; i < argc; i++) {
+        std::string option = argv[i];
+        bool valid = i + 1 < argc;
+
+        if (valid && option == "--programmers") {
+            options.programmers = std::atoi(argv[++i]);
+            valid = options.programmers >= 2;
+        } else if (valid && option == "--rate") {
+            options.rate = std::atof(argv[++i]);
+            valid = options.rate > 0;
+        } else if (valid && option == "--duration") {
+            options.duration_s = std::atof(argv[++i]);
+            valid = options.duration_s > 0;
+        } else if (valid && option == "--timeout") {
+            options.timeout_ms = std::atoi(argv[++i]);
+            valid = options.timeout_ms > 0;
+        } else if (valid && option == "--mix") {
+            valid = parseMix(argv[++i], options.mix);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        if (!valid) {
+            std::cout << "Ошибка: некорректное значение параметра " << option << std::endl;
+            return 1;
+        }
+    }
+
+    Endpoint server(server_ip, server_port);
+    if (server_port <= 0 || server_port > 65535 || !server.valid()) {
+        std::cout << "Ошибка: некорректный адрес сервера" << std::endl;
+        return 1;
+    }
+
+    int sockfd = NetworkUtils::createUDPSocket();
+    if (sockfd < 0 || !NetworkUtils::bindSocket(sockfd, "0.0.0.0", 0)) {
+        std::cout << "Ошибка: не удалось создать сокет" << std::endl;
+        return 1;
+    }
+    setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &SOCKET_BUFFER_BYTES, sizeof(SOCKET_BUFFER_BYTES));
+    setsockopt(sockfd, SOL_SOCKET, SO_SNDBUF, &SOCKET_BUFFER_BYTES, sizeof(SOCKET_BUFFER_BYTES));
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    LoadGenerator generator(options, sockfd, server);
+    if (!generator.registerProgrammers()) {
+        std::cout << "Ошибка: сервер зарегистрировал не всех программистов" << std::endl;
+        close(sockfd);
+        return 1;
+    }
+
+    double heartbeat_rate = options.rate * options.mix[LOAD_HEARTBEAT] /
+                            (options.mix[0] + options.mix[1] + options.mix[2] + options.mix[3]);
+    if (heartbeat_rate * CLIENT_TIMEOUT < options.programmers) {
+        std::cout << "Внимание: HEARTBEAT приходит каждому программисту реже раза в "
+                  << CLIENT_TIMEOUT << " с, сервер может отключить их по таймауту" << std::endl;
+    }
+
+    generator.run();
+    generator.report();
+    close(sockfd);
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "../server/async_log.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Использование: " << argv[0] << " <ЖУРНАЛ> [--level debug|info|warn|error]"
+                  << std::endl;
+        return 1;
+    }
+
+    LogLevel min_level = LOG_DEBUG;
+    if (argc > 3 && strcmp(argv[2], "--level") == 0 &&
+        !AsyncLog::parseLevel(argv[3], min_level)) {
+        std::cout << "Ошибка: неизвестный уровень журнала '" << argv[3] << "'" << std::endl;
+        return 1;
+    }
+
+    FILE* file = fopen(argv[1], "rb");
+    if (!file) {
+        std::cout << "Ошибка: не удалось открыть журнал '" << argv[1] << "'" << std::endl;
+        return 1;
+    }
+
+    if (!AsyncLog::readBinaryHeader(file)) {
+        std::cout << "Ошибка: файл не является двоичным журналом сервера" << std::endl;
+        fclose(file);
+        return 1;
+    }
+
+    LogRecord record;
+    size_t count = 0;
+    long consumed = ftell(file);
+    while (AsyncLog::readBinaryRecord(file, record)) {
+        if (record.header.level >= min_level) {
+            std::string line = AsyncLog::format(record);
+            line.push_back('\n');
+            fwrite(line.data(), 1, line.size(), stdout);
+        }
+        count++;
+        consumed = ftell(file);
+    }
+
+    fseek(file, 0, SEEK_END);
+    bool truncated = ftell(file) != consumed;
+    fclose(file);
+
+    if (truncated) {
+        std::cerr << "Журнал обрезан после записи " << count << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include <time.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../server/programmers_server.h"
+
+enum ReplayPace { PACE_ORIGINAL = 1, PACE_MAX = 2 };
+
+static bool loadJournal(const char* path, uint32_t& seed, std::vector<JournalRecord>& records) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        std::cout << "Ошибка: не удалось открыть журнал трафика '" << path << "'" << std::endl;
+        return false;
+    }
+
+    if (!TrafficJournal::readHeader(file, seed)) {
+        std::cout << "Ошибка: файл не является журналом трафика сервера" << std::endl;
+        fclose(file);
+        return false;
+    }
+
+    JournalRecord record;
+    long consumed = ftell(file);
+    while (TrafficJournal::readRecord(file, record)) {
+        records.push_back(record);
+        consumed = ftell(file);
+    }
+
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) != consumed) {
+        std::cerr << "Журнал трафика обрезан после записи " << records.size() << std::endl;
+    }
+    fclose(file);
+    return true;
+}
+
+static void sleepUntilUs(uint64_t at_us) {
+    uint64_t now = TrafficJournal::monotonicUs();
+    if (at_us <= now) {
+        return;
+    }
+
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>((at_us - now) / 1000000);
+    ts.tv_nsec = static_cast<long>((at_us - now) % 1000000 * 1000);
+    nanosleep(&ts, nullptr);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Использование: " << argv[0]
+                  << " <ЖУРНАЛ_ТРАФИКА> [--pace original|max]"
+                     " [--log-level debug|info|warn|error|off]"
+                  << std::endl;
+        return 1;
+    }
+
+    ReplayPace pace = PACE_MAX;
+    AsyncLog& log = AsyncLog::instance();
+    log.setLevel(LOG_WARN);
+
+    for (int i = 2; i < argc; i++) {
+        std::string option = argv[i];
+
+        if (option == "--pace" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "original") {
+                pace = PACE_ORIGINAL;
+            } else if (value == "max") {
+                pace = PACE_MAX;
+            } else {
+                std::cout << "Ошибка: неизвестный темп воспроизведения '" << value << "'"
+                          << std::endl;
+                return 1;
+            }
+        } else if (option == "--log-level" && i + 1 < argc) {
+            LogLevel level;
+            if (!AsyncLog::parseLevel(argv[++i], level)) {
+                std::cout << "Ошибка: неизвестный уровень журнала '" << argv[i] << "'"
+                          << std::endl;
+                return 1;
+            }
+            log.setLevel(level);
+        } else {
+            std::cout << "Ошибка: неизвестный параметр '" << option << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    uint32_t seed;
+    std::vector<JournalRecord> records;
+    if (!loadJournal(argv[1], seed, records)) {
+        return 1;
+    }
+    if (records.empty()) {
+        std::cout << "Журнал трафика пуст" << std::endl;
+        return 0;
+    }
+
+    ServerOptions options;
+    options.random_seed = seed;
+    ProgrammersServer server("127.0.0.1", 0, options);
+    MemoryTransport* transport = new MemoryTransport();
+    server.attachTransport(std::unique_ptr<Transport>(transport));
+
+    std::vector<Message> replies;
+    std::vector<Endpoint> reply_peers;
+    size_t reply_count = 0;
+    size_t rejected = 0;
+
+    uint64_t first_us = records.front().time_us;
+    uint64_t last_us = first_us;
+    uint64_t started_us = TrafficJournal::monotonicUs();
+
+    for (size_t i = 0; i < records.size(); i++) {
+        const JournalRecord& record = records[i];
+        if (record.truncated ||
+            !transport->deliverDatagram(record.payload, record.length, record.from)) {
+            rejected++;
+        }
+
+        bool batch_end = i + 1 == records.size() || records[i + 1].time_us != record.time_us;
+        if (!batch_end) {
+            continue;
+        }
+
+        if (record.time_us > last_us) {
+            last_us = record.time_us;
+        }
+        if (pace == PACE_ORIGINAL) {
+            sleepUntilUs(started_us + (last_us - first_us));
+            server.advanceTimers();
+        }
+
+        server.pump();
+        transport->takeSent(replies, reply_peers);
+        reply_count += replies.size();
+    }
+
+    double elapsed_s = (TrafficJournal::monotonicUs() - started_us) / 1e6;
+    double recorded_s = (last_us - first_us) / 1e6;
+
+    printf("Воспроизведено датаграмм: %zu (записано за %.3f с) за %.3f с: %.0f сообщений/с, "
+           "%.2f мкс на сообщение; отброшено как некорректные: %zu; ответов сервера: %zu\n",
+           records.size(),
+           recorded_s,
+           elapsed_s,
+           records.size() / elapsed_s,
+           elapsed_s * 1e6 / records.size(),
+           rejected,
+           reply_count);
+    return 0;
+}
@@ -0,0 +1,406 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../programmer_client/programmer_agent.h"
+#include "../server/programmers_server.h"
+
+const uint64_t LATENCY_BUCKET_MS = 100;
+const size_t LATENCY_BUCKETS = 36000;
+const size_t NO_AGENT = SIZE_MAX;
+const uint64_t STALL_MS = 10 * 60 * 1000;
+
+class Simulation : public AgentHost {
+   private:
+    struct TimerEntry {
+        uint64_t at_ms;
+        size_t agent;
+        AgentTimer timer;
+        uint32_t generation;
+
+        bool operator>(const TimerEntry& other) const { return at_ms > other.at_ms; }
+    };
+
+    ManualClock clock;
+    ProgrammersServer server;
+    MemoryTransport* transport;
+    Endpoint clients;
+
+    std::vector<ProgrammerAgent> agents;
+    std::vector<size_t> agent_by_id;
+    size_t registered;
+    std::unordered_map<std::string, size_t> agent_by_name;
+
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<TimerEntry>> timers;
+    std::vector<uint32_t> timer_generation;
+    uint64_t now_ms;
+
+    std::vector<Message> delivered;
+    std::vector<Endpoint> delivered_to;
+
+    std::vector<uint64_t> submitted_at;
+    std::vector<unsigned char> awaiting;
+    std::vector<uint64_t> latency_histogram;
+    uint64_t messages;
+    uint64_t results;
+    uint64_t accepted;
+
+    std::mt19937 gen;
+    std::mt19937 loss_gen;
+    double push_loss;
+    uint64_t dropped;
+
+   public:
+    Simulation(int count, uint32_t seed, double push_loss, const ServerOptions& options)
+        : server("127.0.0.1", 0, withClock(options, &clock)),
+          transport(new MemoryTransport()),
+          clients("127.0.0.1", 1),
+          registered(0),
+          timer_generation(count * AGENT_TIMER_COUNT, 0),
+          now_ms(0),
+          submitted_at(count, 0),
+          awaiting(count, 0),
+          latency_histogram(LATENCY_BUCKETS + 1, 0),
+          messages(0),
+          results(0),
+          accepted(0),
+          gen(seed),
+          loss_gen(seed ^ 0x9e3779b9u),
+          push_loss(push_loss),
+          dropped(0) {
+        server.attachTransport(std::unique_ptr<Transport>(transport));
+
+        agents.reserve(count);
+        for (int i = 0; i < count; i++) {
+            std::string name = "Программист_" + std::to_string(i + 1);
+            agents.push_back(ProgrammerAgent(i, name, *this, false));
+            agent_by_name[name] = i;
+        }
+    }
+
+    void send(const Message& msg) {
+        if (msg.type == SUBMIT_PROGRAM) {
+            size_t agent = agentOf(msg.client_id);
+            if (agent != NO_AGENT) {
+                submitted_at[agent] = now_ms;
+                awaiting[agent] = 1;
+            }
+        }
+        transport->deliver(msg, clients);
+        messages++;
+    }
+
+    void schedule(size_t agent, AgentTimer timer, uint64_t delay_ms) {
+        TimerEntry entry;
+        entry.at_ms = now_ms + delay_ms;
+        entry.agent = agent;
+        entry.timer = timer;
+        entry.generation = ++timer_generation[agent * AGENT_TIMER_COUNT + timer];
+        timers.push(entry);
+    }
+
+    std::mt19937& random() { return gen; }
+
+    bool start() {
+        for (const ProgrammerAgent& agent : agents) {
+            Message request;
+            request.type = REGISTER_PROGRAMMER;
+            snprintf(request.data, sizeof(request.data), "%s", agent.name().c_str());
+            send(request);
+        }
+        pump();
+        return registered == agents.size();
+    }
+
+    void run(uint64_t duration_ms, uint64_t report_ms) {
+        uint64_t end_ms = now_ms + duration_ms;
+        uint64_t report_at = report_ms > 0 ? now_ms + report_ms : end_ms + 1;
+
+        while (!timers.empty() && timers.top().at_ms <= end_ms) {
+            TimerEntry entry = timers.top();
+            timers.pop();
+
+            while (entry.at_ms >= report_at) {
+                std::cout << "[" << formatDuration(report_at) << "] ";
+                printSwarmSummary(agents);
+                report_at += report_ms;
+            }
+
+            advanceTo(entry.at_ms);
+            size_t slot = entry.agent * AGENT_TIMER_COUNT + entry.timer;
+            if (entry.generation == timer_generation[slot]) {
+                agents[entry.agent].onTimer(entry.timer);
+                pump();
+            }
+        }
+        advanceTo(end_ms);
+    }
+
+    void printReport(double wall_s) const {
+        uint64_t speedup = static_cast<uint64_t>(now_ms / 1000.0 / wall_s);
+        std::cout << "Смоделировано " << formatDuration(now_ms) << " за " << wall_s
+                  << " с реального времени (ускорение x" << speedup << ")" << std::endl;
+        printSwarmSummary(agents);
+
+        printf("Циклов проверки: %llu (%.2f млн/с), сообщений серверу: %llu (%.2f млн/с)\n",
+               static_cast<unsigned long long>(results),
+               results / wall_s / 1e6,
+               static_cast<unsigned long long>(messages),
+               messages / wall_s / 1e6);
+
+        if (results > 0) {
+            printf("Время от отправки до результата: среднее %.1f с, p50 %.1f с, p99 %.1f с; "
+                   "принято %.1f%%\n",
+                   latencyMean() / 1000.0,
+                   latencyPercentile(0.50) / 1000.0,
+                   latencyPercentile(0.99) / 1000.0,
+                   100.0 * accepted / results);
+        }
+        if (push_loss > 0) {
+            printf("Потеряно назначений проверки: %llu\n",
+                   static_cast<unsigned long long>(dropped));
+        }
+    }
+
+    size_t stalled() const {
+        size_t count = 0;
+        for (size_t i = 0; i < agents.size(); i++) {
+            if (awaiting[i] && now_ms - submitted_at[i] > STALL_MS) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+   private:
+    static ServerOptions withClock(ServerOptions options, ServerClock* clock) {
+        options.clock = clock;
+        return options;
+    }
+
+    void advanceTo(uint64_t at_ms) {
+        if (at_ms == now_ms) {
+            return;
+        }
+        now_ms = at_ms;
+        clock.set(now_ms);
+        server.advanceTimers();
+    }
+
+    void pump() {
+        while (transport->hasInbound()) {
+            server.pump();
+            transport->takeSent(delivered, delivered_to);
+            for (const Message& msg : delivered) {
+                if (dropPush(msg)) {
+                    continue;
+                }
+                dispatch(msg);
+            }
+        }
+    }
+
+    bool dropPush(const Message& msg) {
+        if (push_loss <= 0 || msg.type != REQUEST_REVIEW || msg.reviewer_id == 0 ||
+            std::uniform_real_distribution<double>(0.0, 1.0)(loss_gen) >= push_loss) {
+            return false;
+        }
+        dropped++;
+        return true;
+    }
+
+    size_t agentOf(int id) const {
+        if (id <= 0 || static_cast<size_t>(id) >= agent_by_id.size()) {
+            return NO_AGENT;
+        }
+        return agent_by_id[id];
+    }
+
+    void dispatch(const Message& msg) {
+        if (msg.type == REGISTER_PROGRAMMER) {
+            auto it = agent_by_name.find(msg.data);
+            if (it != agent_by_name.end() && agents[it->second].id() == 0) {
+                if (static_cast<size_t>(msg.client_id) >= agent_by_id.size()) {
+                    agent_by_id.resize(msg.client_id + 1, NO_AGENT);
+                }
+                agent_by_id[msg.client_id] = it->second;
+                registered++;
+                agents[it->second].registered(msg.client_id);
+            }
+            return;
+        }
+
+        int id = msg.type == REVIEW_RESULT ? msg.target_id : msg.client_id;
+        size_t agent = agentOf(id);
+        if (agent == NO_AGENT) {
+            return;
+        }
+
+        if (msg.type == REVIEW_RESULT) {
+            recordResult(agent, msg.result);
+        }
+        agents[agent].onMessage(msg);
+    }
+
+    void recordResult(size_t agent, ReviewResult result) {
+        uint64_t bucket = (now_ms - submitted_at[agent]) / LATENCY_BUCKET_MS;
+        latency_histogram[bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS]++;
+        awaiting[agent] = 0;
+        results++;
+        if (result == CORRECT) {
+            accepted++;
+        }
+    }
+
+    double latencyMean() const {
+        double sum = 0.0;
+        for (size_t i = 0; i < latency_histogram.size(); i++) {
+            sum += static_cast<double>(latency_histogram[i]) * i * LATENCY_BUCKET_MS;
+        }
+        return sum / results;
+    }
+
+    double latencyPercentile(double fraction) const {
+        uint64_t rank = static_cast<uint64_t>(fraction * (results - 1));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < latency_histogram.size(); i++) {
+            seen += latency_histogram[i];
+            if (seen > rank) {
+                return static_cast<double>(i * LATENCY_BUCKET_MS);
+            }
+        }
+        return static_cast<double>(LATENCY_BUCKETS * LATENCY_BUCKET_MS);
+    }
+
+    static std::string formatDuration(uint64_t ms) {
+        uint64_t s = ms / 1000;
+        char text[64];
+        snprintf(text,
+                 sizeof(text),
+                 "%lluд %02llu:%02llu:%02llu",
+                 static_cast<unsigned long long>(s / 86400),
+                 static_cast<unsigned long long>(s / 3600 % 24),
+                 static_cast<unsigned long long>(s / 60 % 60),
+                 static_cast<unsigned long long>(s % 60));
+        return text;
+    }
+};
+
+static bool parseDuration(const std::string& value, uint64_t& ms) {
+    char* end = nullptr;
+    double amount = std::strtod(value.c_str(), &end);
+    if (end == value.c_str() || amount <= 0) {
+        return false;
+    }
+
+    std::string unit(end);
+    double scale;
+    if (unit.empty() || unit == "s") {
+        scale = 1.0;
+    } else if (unit == "m") {
+        scale = 60.0;
+    } else if (unit == "h") {
+        scale = 3600.0;
+    } else if (unit == "d") {
+        scale = 86400.0;
+    } else {
+        return false;
+    }
+
+    ms = static_cast<uint64_t>(amount * scale * 1000.0);
+    return true;
+}
+
+static void printUsage(const char* program) {
+    std::cout << "Использование: " << program
+              << " [--programmers N] [--duration T] [--report T] [--seed S] [--push-loss P]"
+                 " [--assign least-queue|two-choices|round-robin]"
+                 " [--log-level debug|info|warn|error|off]"
+              << std::endl;
+    std::cout << "T - модельное время с суффиксом s|m|h|d, например 30d" << std::endl;
+    std::cout << "Пример: " << program << " --programmers 1000 --duration 30d --seed 7"
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int count = 100;
+    uint64_t duration_ms = 86400ULL * 1000;
+    uint64_t report_ms = 0;
+    uint32_t seed = 1;
+    double push_loss = 0.0;
+    ServerOptions options;
+    AsyncLog& log = AsyncLog::instance();
+    log.setLevel(LOG_WARN);
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+
+        if (option == "--programmers" && i + 1 < argc) {
+            count = std::atoi(argv[++i]);
+            if (count <= 0) {
+                std::cout << "Ошибка: некорректное число программистов" << std::endl;
+                return 1;
+            }
+        } else if ((option == "--duration" || option == "--report") && i + 1 < argc) {
+            if (!parseDuration(argv[++i], option == "--duration" ? duration_ms : report_ms)) {
+                std::cout << "Ошибка: некорректная длительность '" << argv[i] << "'" << std::endl;
+                return 1;
+            }
+        } else if (option == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--push-loss" && i + 1 < argc) {
+            push_loss = std::strtod(argv[++i], nullptr);
+            if (push_loss < 0 || push_loss >= 1) {
+                std::cout << "Ошибка: доля потерь должна быть в диапазоне [0, 1)" << std::endl;
+                return 1;
+            }
+        } else if (option == "--assign" && i + 1 < argc) {
+            if (!ReviewerPicker::parsePolicy(argv[++i], options.assign_policy)) {
+                std::cout << "Ошибка: неизвестная политика назначения '" << argv[i] << "'"
+                          << std::endl;
+                return 1;
+            }
+        } else if (option == "--log-level" && i + 1 < argc) {
+            LogLevel level;
+            if (!AsyncLog::parseLevel(argv[++i], level)) {
+                std::cout << "Ошибка: неизвестный уровень журнала '" << argv[i] << "'"
+                          << std::endl;
+                return 1;
+            }
+            log.setLevel(level);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    options.random_seed = seed + 1;
+    Simulation simulation(count, seed, push_loss, options);
+
+    std::cout << "Моделирование: " << count << " программистов, seed " << seed << std::endl;
+
+    auto started = std::chrono::steady_clock::now();
+    if (!simulation.start()) {
+        std::cout << "Ошибка: не все программисты зарегистрированы" << std::endl;
+        return 1;
+    }
+    simulation.run(duration_ms, report_ms);
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - started;
+
+    simulation.printReport(wall.count());
+
+    size_t stalled = simulation.stalled();
+    if (stalled > 0) {
+        std::cout << "Ошибка: " << stalled << " программистов ждут результата проверки дольше "
+                  << STALL_MS / 60000 << " мин" << std::endl;
+        return 1;
+    }
+    return 0;
+}